@@ -40,18 +40,15 @@ int main(int argc, char** argv){
 
     
 
-    bitboard_player_set bb;
-    bitboard_player_set bbo(true);
-    bb.pawns = 0;
-    bb.barrier = (uint64_t)1<<18 | (uint64_t)1<<34 | (uint64_t)1<<27;
-    bb.rooks = 1<<26 | 1 <<29;
-    bb.knights = 0;
-    bb.bishops = 0;
-    bb.king = 0;
-    bb.queen = 0;
-    print_board("Player Rook", bb.rooks); 
+    bitboard_frame frm;
+    frm.set_pieces(PLAYER_OFFSET, PAWN_OFFSET, 0);
+    frm.set_pieces(PLAYER_OFFSET, KNIGHT_OFFSET, (uint64_t)1<<18 | (uint64_t)1<<34 | (uint64_t)1<<27);
+    frm.set_pieces(PLAYER_OFFSET, ROOK_OFFSET, 1<<26 | 1 <<29);
+    frm.set_pieces(PLAYER_OFFSET, BISHOP_OFFSET, 0);
+    frm.set_pieces(PLAYER_OFFSET, KING_OFFSET, 0);
+    frm.set_pieces(PLAYER_OFFSET, QUEEN_OFFSET, 0);
+    print_board("Player Rook", frm.player.pieces[ROOK_OFFSET]); 
 
-   bitboard_frame frm(bb,bbo);
    int i =1;
    print_frame("Start", frm);
    for(auto& frame : frm.get_next_boards()){
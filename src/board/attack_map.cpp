@@ -0,0 +1,96 @@
+#include "attack_map.h"
+#include "attacks.h"
+
+#include <cstring>
+
+namespace{
+uint64_t side_sliders(const bitboard_frame& frame, size_t side){
+    return frame.side(side).pieces[ROOK_OFFSET] | frame.side(side).pieces[BISHOP_OFFSET] | frame.side(side).pieces[QUEEN_OFFSET];
+}
+
+uint64_t sliders(const bitboard_frame& frame){
+    return side_sliders(frame, PLAYER_OFFSET) | side_sliders(frame, OPPONENT_OFFSET);
+}
+
+uint64_t changed_squares(const bitboard_frame& before, const bitboard_frame& after){
+    uint64_t changed{0};
+    for(size_t side=0; side<SIDES; ++side){
+        for(size_t piece=0; piece<PIECE_TYPES; ++piece){
+            changed |= before.side(side).pieces[piece] ^ after.side(side).pieces[piece];
+        }
+    }
+    return changed;
+}
+
+void adjust_counts(uint8_t* counts, uint64_t squares, int delta){
+    while(squares){
+        counts[__builtin_ctzll(squares)] += delta;
+        squares &= squares-1;
+    }
+}
+
+uint64_t union_of(const uint64_t* from_square, uint64_t squares){
+    uint64_t board{0};
+    while(squares){
+        board |= from_square[__builtin_ctzll(squares)];
+        squares &= squares-1;
+    }
+    return board;
+}
+}
+
+attack_map::attack_map(const bitboard_frame& frame){
+    build(frame);
+}
+
+void attack_map::build(const bitboard_frame& frame){
+    std::memset(from_square, 0, sizeof(from_square));
+    std::memset(counts, 0, sizeof(counts));
+    for(size_t side=0; side<SIDES; ++side){
+        auto own {frame.side(side).occupancy};
+        while(own){
+            auto square {(size_t)__builtin_ctzll(own)};
+            from_square[square] = attacks_from(frame, side, square);
+            adjust_counts(counts[side], from_square[square], 1);
+            own &= own-1;
+        }
+        attacked[side] = union_of(from_square, frame.side(side).occupancy);
+        slider_attacked[side] = union_of(from_square, side_sliders(frame, side));
+    }
+}
+
+void attack_map::update(const bitboard_frame& before, const bitboard_frame& after){
+    auto changed {changed_squares(before, after)};
+    if(!changed){
+        return;
+    }
+    // a ray that reached a changed square now stops earlier or runs further
+    auto stale {changed};
+    auto rays {sliders(before) & sliders(after) & ~changed};
+    while(rays){
+        auto square {(size_t)__builtin_ctzll(rays)};
+        if(from_square[square] & changed){
+            stale |= (uint64_t)1<<square;
+        }
+        rays &= rays-1;
+    }
+
+    while(stale){
+        auto square {(size_t)__builtin_ctzll(stale)};
+        uint64_t mask {(uint64_t)1<<square};
+        if(before.occupied & mask){
+            adjust_counts(counts[before.player.occupancy & mask? PLAYER_OFFSET : OPPONENT_OFFSET], from_square[square], -1);
+        }
+        from_square[square] = 0;
+        if(after.occupied & mask){
+            auto side {after.player.occupancy & mask? PLAYER_OFFSET : OPPONENT_OFFSET};
+            from_square[square] = attacks_from(after, side, square);
+            adjust_counts(counts[side], from_square[square], 1);
+        }
+        stale &= stale-1;
+    }
+    for(size_t side=0; side<SIDES; ++side){
+        attacked[side] = union_of(from_square, after.side(side).occupancy);
+        slider_attacked[side] = union_of(from_square, side_sliders(after, side));
+    }
+}
@@ -0,0 +1,76 @@
+#include "attacks.h"
+
+namespace{
+uint64_t ray_attacks(size_t square, int row_step, int col_step, uint64_t occupied){
+    uint64_t attacks{0};
+    int row {(int)(square/BOARDSIZE) + row_step};
+    int col {(int)(square%BOARDSIZE) + col_step};
+    while(row >= 0 && row < (int)BOARDSIZE && col >= 0 && col < (int)BOARDSIZE){
+        uint64_t mask {(uint64_t)1<<compute_distance(row, col)};
+        attacks |= mask;
+        if(occupied & mask){
+            break;
+        }
+        row += row_step;
+        col += col_step;
+    }
+    return attacks;
+}
+}
+
+uint64_t pawn_attacks(size_t side_offset, uint64_t pawns){
+    if(side_offset == PLAYER_OFFSET){
+        return ((pawns&MASK_OFF_LEFT)<<9) | ((pawns&MASK_OFF_RIGHT)<<7);
+    }
+    return ((pawns&MASK_OFF_RIGHT)>>9) | ((pawns&MASK_OFF_LEFT)>>7);
+}
+
+uint64_t knight_attacks(uint64_t knights){
+    auto one_col {((knights>>1)&MASK_OFF_LEFT) | ((knights<<1)&MASK_OFF_RIGHT)};
+    auto two_cols {((knights>>2)&MASK_OFF_LEFT_DOUBLE) | ((knights<<2)&MASK_OFF_RIGHT_DOUBLE)};
+    return one_col<<16 | one_col>>16 | two_cols<<8 | two_cols>>8;
+}
+
+uint64_t king_attacks(uint64_t kings){
+    auto row {kings | ((kings>>1)&MASK_OFF_LEFT) | ((kings<<1)&MASK_OFF_RIGHT)};
+    return (row | row<<8 | row>>8) & ~kings;
+}
+
+uint64_t rook_attacks(size_t square, uint64_t occupied){
+    return ray_attacks(square, 1, 0, occupied) | ray_attacks(square, -1, 0, occupied)
+        | ray_attacks(square, 0, 1, occupied) | ray_attacks(square, 0, -1, occupied);
+}
+
+uint64_t bishop_attacks(size_t square, uint64_t occupied){
+    return ray_attacks(square, 1, 1, occupied) | ray_attacks(square, 1, -1, occupied)
+        | ray_attacks(square, -1, 1, occupied) | ray_attacks(square, -1, -1, occupied);
+}
+
+uint64_t attacks_from(const bitboard_frame& frame, size_t side_offset, size_t square){
+    switch(frame.piece_at(side_offset, square)){
+        case PAWN_OFFSET: return pawn_attacks(side_offset, (uint64_t)1<<square);
+        case KNIGHT_OFFSET: return knight_attacks((uint64_t)1<<square);
+        case KING_OFFSET: return king_attacks((uint64_t)1<<square);
+        case ROOK_OFFSET: return rook_attacks(square, frame.occupied);
+        case BISHOP_OFFSET: return bishop_attacks(square, frame.occupied);
+        case QUEEN_OFFSET: return rook_attacks(square, frame.occupied) | bishop_attacks(square, frame.occupied);
+    }
+    return 0;
+}
+
+uint64_t attackers_to(const bitboard_frame& frame, size_t square, uint64_t occupied){
+    uint64_t target {(uint64_t)1<<square};
+    auto& player {frame.player.pieces};
+    auto& opponent {frame.opponent.pieces};
+    auto straight {player[ROOK_OFFSET] | player[QUEEN_OFFSET] | opponent[ROOK_OFFSET] | opponent[QUEEN_OFFSET]};
+    auto diagonal {player[BISHOP_OFFSET] | player[QUEEN_OFFSET] | opponent[BISHOP_OFFSET] | opponent[QUEEN_OFFSET]};
+
+    // a pawn attacks the square if a pawn of the other color on it would attack the pawn
+    auto attackers {(pawn_attacks(OPPONENT_OFFSET, target) & player[PAWN_OFFSET])
+        | (pawn_attacks(PLAYER_OFFSET, target) & opponent[PAWN_OFFSET])};
+    attackers |= knight_attacks(target) & (player[KNIGHT_OFFSET] | opponent[KNIGHT_OFFSET]);
+    attackers |= king_attacks(target) & (player[KING_OFFSET] | opponent[KING_OFFSET]);
+    attackers |= rook_attacks(square, occupied) & straight;
+    attackers |= bishop_attacks(square, occupied) & diagonal;
+    return attackers & occupied;
+}
@@ -1,135 +1,207 @@
 #include "bitboard.h"
+#include "attacks.h"
+#include "engine_stats.h"
 
 #include <iostream>
 
-bitboard_player_set::bitboard_player_set(bool opponent){
-    auto pawn_row = opponent? 6 : 1;
-    auto main_row = opponent? 7 : 0;
-
-    this->pawns = start_pawns(pawn_row);
-    this->king = start_king(main_row);
-    this->queen = start_queen(main_row);
-    this->bishops = start_bishop(main_row);
-    this->knights = start_knight(main_row);
-    this->rooks = start_rook(main_row);
-    #ifdef UNITTEST
-    this->barrier= start_rook(main_row);
-    #endif
+bitboard_frame::bitboard_frame(){
+    clear();
+    set_pieces(PLAYER_OFFSET, PAWN_OFFSET, start_pawns(1));
+    set_pieces(PLAYER_OFFSET, ROOK_OFFSET, start_rook(0));
+    set_pieces(PLAYER_OFFSET, BISHOP_OFFSET, start_bishop(0));
+    set_pieces(PLAYER_OFFSET, KNIGHT_OFFSET, start_knight(0));
+    set_pieces(PLAYER_OFFSET, KING_OFFSET, start_king(0));
+    set_pieces(PLAYER_OFFSET, QUEEN_OFFSET, start_queen(0));
+    set_pieces(OPPONENT_OFFSET, PAWN_OFFSET, start_pawns(6));
+    set_pieces(OPPONENT_OFFSET, ROOK_OFFSET, start_rook(7));
+    set_pieces(OPPONENT_OFFSET, BISHOP_OFFSET, start_bishop(7));
+    set_pieces(OPPONENT_OFFSET, KNIGHT_OFFSET, start_knight(7));
+    set_pieces(OPPONENT_OFFSET, KING_OFFSET, start_king(7));
+    set_pieces(OPPONENT_OFFSET, QUEEN_OFFSET, start_queen(7));
 }
 
-uint64_t bitboard_player_set::full_player_board(){
-#ifdef UNITTEST
-    return this->pawns | this->rooks | this->bishops | this->knights | this->king | this->queen | this->barrier;
-#endif
-    return this->pawns | this->rooks | this->bishops | this->knights | this->king | this->queen;
+bitboard_frame bitboard_frame::empty(){
+    bitboard_frame frame;
+    frame.clear();
+    return frame;
 }
 
-void bitboard_player_set::remove_piece(size_t struct_offset, size_t absolute_position){
-    auto piece {reinterpret_cast<uint64_t*>(this) + struct_offset};
-    *piece &= ~((uint64_t)(1)<<absolute_position);
+void bitboard_frame::clear(){
+    player = side_boards{};
+    opponent = side_boards{};
+    occupied = 0;
 }
 
-void bitboard_player_set::remove_pieces(size_t absolute_position){
-    pawns &= ~((uint64_t)(1)<<absolute_position);
-    rooks &= ~((uint64_t)(1)<<absolute_position);
-    bishops &= ~((uint64_t)(1)<<absolute_position);
-    knights &= ~((uint64_t)(1)<<absolute_position);
-    queen &= ~((uint64_t)(1)<<absolute_position);
+size_t bitboard_frame::piece_at(size_t side_offset, size_t absolute_position) const{
+    uint64_t mask {(uint64_t)(1)<<absolute_position};
+    auto& own {side(side_offset)};
+    if(!(own.occupancy&mask)){
+        return NO_PIECE_OFFSET;
+    }
+    for(size_t piece=0; piece<PIECE_TYPES; ++piece){
+        if(own.pieces[piece]&mask){
+            return piece;
+        }
+    }
+    return NO_PIECE_OFFSET;
 }
 
-void bitboard_player_set::move_piece(size_t struct_offset, size_t from_position, size_t to_position){
-    auto piece {reinterpret_cast<uint64_t*>(this) + struct_offset};
-    *piece &= ~((uint64_t)(1)<<from_position);
-    *piece |= (uint64_t)(1)<<to_position;
+void bitboard_frame::set_pieces(size_t side_offset, size_t struct_offset, uint64_t board){
+    auto& own {side(side_offset)};
+    own.pieces[struct_offset] = board;
+    own.occupancy = 0;
+    for(size_t piece=0; piece<PIECE_TYPES; ++piece){
+        own.occupancy |= own.pieces[piece];
+    }
+    occupied = player.occupancy | opponent.occupancy;
 }
 
-bitboard_frame::bitboard_frame(bitboard_player_set player, bitboard_player_set opponent):
-player{player}, opponent{opponent} {}
+void bitboard_frame::add_piece(size_t side_offset, size_t struct_offset, size_t absolute_position){
+    uint64_t mask {(uint64_t)(1)<<absolute_position};
+    auto& own {side(side_offset)};
+    own.pieces[struct_offset] |= mask;
+    own.occupancy |= mask;
+    occupied |= mask;
+}
 
-ascii_array bitboard_frame::to_ascii_array(){
+void bitboard_frame::remove_piece(size_t side_offset, size_t struct_offset, size_t absolute_position){
+    uint64_t mask {(uint64_t)(1)<<absolute_position};
+    auto& own {side(side_offset)};
+    if(!(own.pieces[struct_offset]&mask)){
+        return;
+    }
+    own.pieces[struct_offset] &= ~mask;
+    own.occupancy &= ~mask;
+    occupied = player.occupancy | opponent.occupancy;
+}
+
+void bitboard_frame::remove_pieces(size_t side_offset, size_t absolute_position){
+    uint64_t mask {(uint64_t)(1)<<absolute_position};
+    auto& own {side(side_offset)};
+    if(!(own.occupancy&mask)){
+        return;
+    }
+    for(size_t piece=0; piece<PIECE_TYPES; ++piece){
+        own.pieces[piece] &= ~mask;
+    }
+    own.occupancy &= ~mask;
+    //a capturing piece may already stand on the square
+    occupied = player.occupancy | opponent.occupancy;
+}
+
+void bitboard_frame::move_piece(size_t side_offset, size_t struct_offset, size_t from_position, size_t to_position){
+    uint64_t from_mask {(uint64_t)(1)<<from_position};
+    uint64_t to_mask {(uint64_t)(1)<<to_position};
+    auto& own {side(side_offset)};
+    own.pieces[struct_offset] = (own.pieces[struct_offset]&~from_mask) | to_mask;
+    own.occupancy = (own.occupancy&~from_mask) | to_mask;
+    occupied = (occupied&~from_mask) | to_mask;
+}
+
+ascii_array bitboard_frame::to_ascii_array() const{
+    const char letters[SIDES][PIECE_TYPES+1] {"PRBNKQ", "prbnkq"};
     ascii_array arr;
-    size_t pos{1};
-    for(int i=0;i<64;++i){
-        if(pos&player.pawns){
-            arr.data[i] = 'P';
-        }
-        else if(pos&opponent.pawns){
-            arr.data[i] = 'p';
-        }
-        else if(pos&player.rooks){
-            arr.data[i] = 'R';
-        }
-        else if(pos&opponent.rooks){
-            arr.data[i] = 'r';
-        }
-        else if(pos&player.knights){
-            arr.data[i] = 'N';
-        }
-        else if(pos&opponent.knights){
-            arr.data[i] = 'n';
-        }
-        else if(pos&player.bishops){
-            arr.data[i] = 'B';
-        }
-        else if(pos&opponent.bishops){
-            arr.data[i] = 'b';
-        }
-        else if(pos&player.queen){
-            arr.data[i] = 'Q';
-        }
-        else if(pos&opponent.queen){
-            arr.data[i] = 'q';
-        }
-        else if(pos&player.king){
-            arr.data[i] = 'k';
-        }
-        else if(pos&opponent.king){
-            arr.data[i] = 'k';
-        }
-        #ifdef UNITTEST
-        else if(pos&player.barrier){
-            arr.data[i] = '*';
-        }
-        #endif
-        else{
-            arr.data[i] = '.';
+    for(size_t i=0; i<64; ++i){
+        arr.data[i] = '.';
+        for(size_t side=0; side<SIDES; ++side){
+            auto piece {piece_at(side, i)};
+            if(piece != NO_PIECE_OFFSET){
+                arr.data[i] = letters[side][piece];
+            }
         }
-        pos<<=1;
     }
     return arr;
 }
 
-bitboard_frame bitboard_frame::clone_from_player_move(size_t struct_offset, size_t from_position, size_t to_position){
+bitboard_frame bitboard_frame::clone_from_player_move(size_t struct_offset, size_t from_position, size_t to_position) const{
     bitboard_frame moved_frame{*this};
-    moved_frame.player.move_piece(struct_offset, from_position,to_position);
+    moved_frame.move_piece(PLAYER_OFFSET, struct_offset, from_position,to_position);
     return moved_frame;
 }
 
-bitboard_frame bitboard_frame::clone_from_opponent_move(size_t struct_offset, size_t from_position, size_t to_position){
+bitboard_frame bitboard_frame::clone_from_opponent_move(size_t struct_offset, size_t from_position, size_t to_position) const{
     bitboard_frame moved_frame{*this};
-    moved_frame.opponent.move_piece(struct_offset, from_position,to_position);
+    moved_frame.move_piece(OPPONENT_OFFSET, struct_offset, from_position,to_position);
     return moved_frame;
 }
 
-std::vector<bitboard_frame> bitboard_frame::get_next_boards(){
-    std::vector<bitboard_frame> next_boards;
-    auto self_board{player.full_player_board()};
-    auto opp_board{opponent.full_player_board()};
+bitboard_frame bitboard_frame::clone_from_played_move(size_t side_offset, size_t from_position, size_t to_position, size_t promotion_offset) const{
+    bitboard_frame moved_frame{*this};
+    auto other_side {side_offset == PLAYER_OFFSET? OPPONENT_OFFSET : PLAYER_OFFSET};
+    auto piece {piece_at(side_offset, from_position)};
+    if(piece == NO_PIECE_OFFSET){
+        return moved_frame;
+    }
+
+    //en passant: a pawn changing file onto an empty square takes the pawn behind it
+    if(piece == PAWN_OFFSET && from_position%BOARDSIZE != to_position%BOARDSIZE && piece_at(other_side, to_position) == NO_PIECE_OFFSET){
+        moved_frame.remove_pieces(other_side, side_offset == PLAYER_OFFSET? to_position-BOARDSIZE : to_position+BOARDSIZE);
+    }
+    moved_frame.remove_pieces(other_side, to_position);
+    moved_frame.move_piece(side_offset, piece, from_position, to_position);
+
+    if(promotion_offset != NO_PIECE_OFFSET){
+        moved_frame.remove_piece(side_offset, piece, to_position);
+        moved_frame.add_piece(side_offset, promotion_offset, to_position);
+    }
+
+    //castling: the king travels two files and the rook jumps over it
+    if(piece == KING_OFFSET && (from_position == to_position+2 || to_position == from_position+2)){
+        auto row_start {from_position - from_position%BOARDSIZE};
+        if(to_position > from_position){
+            moved_frame.move_piece(side_offset, ROOK_OFFSET, row_start+BOARDSIZE-1, from_position+1);
+        }
+        else{
+            moved_frame.move_piece(side_offset, ROOK_OFFSET, row_start, from_position-1);
+        }
+    }
+    return moved_frame;
+}
+
+frame_move bitboard_frame::move_between(const bitboard_frame& next, size_t side_offset) const{
+    auto other_side {side_offset == PLAYER_OFFSET? OPPONENT_OFFSET : PLAYER_OFFSET};
+    auto from_bits {side(side_offset).occupancy & ~next.side(side_offset).occupancy};
+    auto to_bits {next.side(side_offset).occupancy & ~side(side_offset).occupancy};
+    //castling moves two pieces, the king's squares name the move
+    if(from_bits & side(side_offset).pieces[KING_OFFSET]){
+        from_bits &= side(side_offset).pieces[KING_OFFSET];
+        to_bits &= next.side(side_offset).pieces[KING_OFFSET];
+    }
+
+    frame_move move;
+    move.from_position = from_bits? __builtin_ctzll(from_bits) : 0;
+    move.to_position = to_bits? __builtin_ctzll(to_bits) : 0;
+    move.piece_offset = piece_at(side_offset, move.from_position);
+    auto arrived {next.piece_at(side_offset, move.to_position)};
+    move.promotion_offset = arrived != move.piece_offset? arrived : NO_PIECE_OFFSET;
+    move.capture = (side(other_side).occupancy & ~next.side(other_side).occupancy) != 0;
+    return move;
+}
+
+namespace{
+template<typename Boards>
+void fill_next_boards(bitboard_frame& frame, Boards& next_boards){
+    STATS_INC(generation_calls);
+    STATS_CLOCK(generation_clock);
+    auto self_board{frame.player.occupancy};
+    auto opp_board{frame.opponent.occupancy};
     auto strike_move{~self_board&opp_board};
-    auto nonstrike_move{~self_board&~opp_board};
+    auto nonstrike_move{~frame.occupied};
 
     //pawns
-    auto p_move1 {(player.pawns<<8)&nonstrike_move};
-    auto  p_move2 {(player.pawns<<16)&nonstrike_move};
-    auto p_strike_left {((player.pawns&MASK_OFF_LEFT)<<9)&strike_move};
-    auto p_strike_right {((player.pawns&MASK_OFF_RIGHT)<<7)&strike_move};
+    auto p_move1 {(frame.player.pieces[PAWN_OFFSET]<<8)&nonstrike_move};
+    auto  p_move2 {(frame.player.pieces[PAWN_OFFSET]<<16)&nonstrike_move};
+    auto p_strike_left {((frame.player.pieces[PAWN_OFFSET]&MASK_OFF_LEFT)<<9)&strike_move};
+    auto p_strike_right {((frame.player.pieces[PAWN_OFFSET]&MASK_OFF_RIGHT)<<7)&strike_move};
+
+    STATS_LAP(generation_clock, PAWN_OFFSET);
 
     //rooks
     uint64_t rookmove_list[28];
     int rookmove_dist[28];
     size_t rookmove_count{0};
     int move_dist{0};
-    auto cur_rooks{player.rooks};
+    auto cur_rooks{frame.player.pieces[ROOK_OFFSET]};
     decltype(cur_rooks) potential_move{0};
     while(cur_rooks){
         cur_rooks<<=8;
@@ -142,7 +214,7 @@ std::vector<bitboard_frame> bitboard_frame::get_next_boards(){
         cur_rooks&=nonstrike_move; //ensure strike moves end progression
     }
 
-    cur_rooks = player.rooks;
+    cur_rooks = frame.player.pieces[ROOK_OFFSET];
     move_dist = 0;
     while(cur_rooks){
         cur_rooks>>=8;
@@ -155,154 +227,223 @@ std::vector<bitboard_frame> bitboard_frame::get_next_boards(){
         cur_rooks&=nonstrike_move; //ensure strike moves end progression
     }
 
-    cur_rooks = player.rooks;
+    cur_rooks = frame.player.pieces[ROOK_OFFSET];
     move_dist = 0;
     while(cur_rooks){
-        cur_rooks<<=1;
+        cur_rooks=(cur_rooks&MASK_OFF_LEFT)<<1; //no wrapping onto the next row
         potential_move=cur_rooks&~self_board;
         move_dist +=1;
         if(potential_move){
             rookmove_dist[rookmove_count] = move_dist;
             rookmove_list[rookmove_count++] = potential_move;
         }
-        cur_rooks&=nonstrike_move&MASK_OFF_LEFT; //ensure strike moves end progression
-        
+        cur_rooks&=nonstrike_move; //ensure strike moves end progression
     }
 
-    cur_rooks = player.rooks;
+    cur_rooks = frame.player.pieces[ROOK_OFFSET];
     move_dist = 0;
     while(cur_rooks){
-        cur_rooks>>=1;
+        cur_rooks=(cur_rooks&MASK_OFF_RIGHT)>>1; //no wrapping onto the previous row
         potential_move=cur_rooks&~self_board;
         move_dist -=1;
         if(potential_move){
             rookmove_dist[rookmove_count] = move_dist;
             rookmove_list[rookmove_count++] = potential_move;
         }
-        cur_rooks&=nonstrike_move&MASK_OFF_RIGHT; //ensure strike moves end progression
+        cur_rooks&=nonstrike_move; //ensure strike moves end progression
     }
 
+    STATS_LAP(generation_clock, ROOK_OFFSET);
+
     for(size_t i=0; i<64; ++i){
         uint64_t mask {(uint64_t)1<<i};
         if(mask & p_move1){
-            next_boards.emplace_back(clone_from_player_move(PAWN_OFFSET, i-8, i));
+            next_boards.emplace_back(frame.clone_from_player_move(PAWN_OFFSET, i-8, i));
             if(mask<<8 & p_move2 && i <24){
-                next_boards.emplace_back(clone_from_player_move(PAWN_OFFSET, i-8, i+8));
+                next_boards.emplace_back(frame.clone_from_player_move(PAWN_OFFSET, i-8, i+8));
             }
         }
         if(mask & p_strike_left){
-            next_boards.emplace_back(clone_from_player_move(PAWN_OFFSET,i-9,i));    
-            next_boards.back().opponent.remove_pieces(i);
+            next_boards.emplace_back(frame.clone_from_player_move(PAWN_OFFSET,i-9,i));    
+            next_boards.back().remove_pieces(OPPONENT_OFFSET, i);
         }
         if(mask & p_strike_right){
-            next_boards.emplace_back(clone_from_player_move(PAWN_OFFSET,i-7,i));    
-            next_boards.back().opponent.remove_pieces(i);
+            next_boards.emplace_back(frame.clone_from_player_move(PAWN_OFFSET,i-7,i));    
+            next_boards.back().remove_pieces(OPPONENT_OFFSET, i);
         }
         for(size_t rook_idx=0;rook_idx<rookmove_count;++rook_idx){
             if(mask & rookmove_list[rook_idx]){
-                next_boards.emplace_back(clone_from_player_move(ROOK_OFFSET,i-rookmove_dist[rook_idx],i));    
-                next_boards.back().opponent.remove_pieces(i);
+                next_boards.emplace_back(frame.clone_from_player_move(ROOK_OFFSET,i-rookmove_dist[rook_idx],i));    
+                next_boards.back().remove_pieces(OPPONENT_OFFSET, i);
             }
         }
     }
-
-    return next_boards;
+    STATS_LAP(generation_clock, STATS_EMIT_SLOT);
+    STATS_ADD(generated_boards, next_boards.size());
 }
 
-std::vector<bitboard_frame> bitboard_frame::get_opponent_next_boards(){
-   std::vector<bitboard_frame> next_boards;
-    auto self_board{opponent.full_player_board()};
-    auto opp_board{player.full_player_board()};
+template<typename Boards>
+void fill_opponent_next_boards(bitboard_frame& frame, Boards& next_boards){
+    STATS_INC(generation_calls);
+    STATS_CLOCK(generation_clock);
+    auto self_board{frame.opponent.occupancy};
+    auto opp_board{frame.player.occupancy};
     auto strike_move{~self_board&opp_board};
-    auto nonstrike_move{~self_board&~opp_board};
+    auto nonstrike_move{~frame.occupied};
 
     //pawns
-    auto p_move1 {(opponent.pawns>>8)&nonstrike_move};
-    auto p_move2 {(opponent.pawns>>16)&nonstrike_move};
-    auto p_strike_left {((opponent.pawns&MASK_OFF_RIGHT)>>9)&strike_move};
-    auto p_strike_right {((opponent.pawns&MASK_OFF_LEFT)>>7)&strike_move};
+    auto p_move1 {(frame.opponent.pieces[PAWN_OFFSET]>>8)&nonstrike_move};
+    auto p_move2 {(frame.opponent.pieces[PAWN_OFFSET]>>16)&nonstrike_move};
+    auto p_strike_left {((frame.opponent.pieces[PAWN_OFFSET]&MASK_OFF_RIGHT)>>9)&strike_move};
+    auto p_strike_right {((frame.opponent.pieces[PAWN_OFFSET]&MASK_OFF_LEFT)>>7)&strike_move};
+
+    STATS_LAP(generation_clock, PAWN_OFFSET);
 
     //rooks
-    uint64_t rookmove_list[14];
-    int rookmove_dist[14];
+    uint64_t rookmove_list[28];
+    int rookmove_dist[28];
     size_t rookmove_count{0};
     int move_dist{0};
-    auto cur_rooks{player.rooks};
+    auto cur_rooks{frame.opponent.pieces[ROOK_OFFSET]};
+    decltype(cur_rooks) potential_move{0};
     while(cur_rooks){
         cur_rooks<<=8;
+        potential_move=cur_rooks&~self_board;
         move_dist +=8;
-        if(cur_rooks&nonstrike_move){
+        if(potential_move){
             rookmove_dist[rookmove_count] = move_dist;
-            rookmove_list[rookmove_count++] = cur_rooks;
+            rookmove_list[rookmove_count++] = potential_move;
         }
         cur_rooks&=nonstrike_move; //ensure strike moves end progression
     }
 
-    cur_rooks = player.rooks;
-    rookmove_count=0;
+    cur_rooks = frame.opponent.pieces[ROOK_OFFSET];
     move_dist = 0;
     while(cur_rooks){
         cur_rooks>>=8;
+        potential_move=cur_rooks&~self_board;
         move_dist -=8;
-        if(cur_rooks&nonstrike_move){
+        if(potential_move){
             rookmove_dist[rookmove_count] = move_dist;
-            rookmove_list[rookmove_count++] = cur_rooks;
+            rookmove_list[rookmove_count++] = potential_move;
         }
         cur_rooks&=nonstrike_move; //ensure strike moves end progression
     }
 
-    cur_rooks = player.rooks;
-    rookmove_count=0;
+    cur_rooks = frame.opponent.pieces[ROOK_OFFSET];
     move_dist = 0;
     while(cur_rooks){
-        cur_rooks<<=1;
+        cur_rooks=(cur_rooks&MASK_OFF_LEFT)<<1; //no wrapping onto the next row
+        potential_move=cur_rooks&~self_board;
         move_dist +=1;
-        if(cur_rooks&nonstrike_move){
+        if(potential_move){
             rookmove_dist[rookmove_count] = move_dist;
-            rookmove_list[rookmove_count++] = cur_rooks;
+            rookmove_list[rookmove_count++] = potential_move;
         }
         cur_rooks&=nonstrike_move; //ensure strike moves end progression
     }
 
-    cur_rooks = player.rooks;
-    rookmove_count=0;
+    cur_rooks = frame.opponent.pieces[ROOK_OFFSET];
     move_dist = 0;
     while(cur_rooks){
-        cur_rooks>>=1;
+        cur_rooks=(cur_rooks&MASK_OFF_RIGHT)>>1; //no wrapping onto the previous row
+        potential_move=cur_rooks&~self_board;
         move_dist -=1;
-        if(cur_rooks&nonstrike_move){
+        if(potential_move){
             rookmove_dist[rookmove_count] = move_dist;
-            rookmove_list[rookmove_count++] = cur_rooks;
+            rookmove_list[rookmove_count++] = potential_move;
         }
         cur_rooks&=nonstrike_move; //ensure strike moves end progression
     }
 
+    STATS_LAP(generation_clock, ROOK_OFFSET);
+
     for(size_t i=0; i<64; ++i){
         uint64_t mask {(uint64_t)1<<i};
 
         //pawns
         if(mask & p_move1){
-            next_boards.emplace_back(clone_from_opponent_move(PAWN_OFFSET, i+8, i));
+            next_boards.emplace_back(frame.clone_from_opponent_move(PAWN_OFFSET, i+8, i));
             if(mask>>8 & p_move2 && i >39){
-                next_boards.emplace_back(clone_from_opponent_move(PAWN_OFFSET, i+8, i-8));
+                next_boards.emplace_back(frame.clone_from_opponent_move(PAWN_OFFSET, i+8, i-8));
             }
         }
         if(mask & p_strike_left){
-            next_boards.emplace_back(clone_from_opponent_move(PAWN_OFFSET,i+9,i));    
-            next_boards.back().player.remove_pieces(i);
+            next_boards.emplace_back(frame.clone_from_opponent_move(PAWN_OFFSET,i+9,i));    
+            next_boards.back().remove_pieces(PLAYER_OFFSET, i);
         }
         if(mask & p_strike_right){
-            next_boards.emplace_back(clone_from_opponent_move(PAWN_OFFSET,i+7,i));    
-            next_boards.back().player.remove_pieces(i);
+            next_boards.emplace_back(frame.clone_from_opponent_move(PAWN_OFFSET,i+7,i));    
+            next_boards.back().remove_pieces(PLAYER_OFFSET, i);
         }
 
         for(size_t rook_idx=0;rook_idx<rookmove_count;++rook_idx){
             if(mask & rookmove_list[rook_idx]){
-                next_boards.emplace_back(clone_from_opponent_move(ROOK_OFFSET,i-rookmove_dist[rook_idx],i));    
-                next_boards.back().player.remove_pieces(i);
+                next_boards.emplace_back(frame.clone_from_opponent_move(ROOK_OFFSET,i-rookmove_dist[rook_idx],i));    
+                next_boards.back().remove_pieces(PLAYER_OFFSET, i);
             }
         }
     }
+    STATS_LAP(generation_clock, STATS_EMIT_SLOT);
+    STATS_ADD(generated_boards, next_boards.size());
+}
+}
+
+std::vector<bitboard_frame> bitboard_frame::get_next_boards(){
+    std::vector<bitboard_frame> next_boards;
+    fill_next_boards(*this, next_boards);
+    return next_boards;
+}
+
+arena_span<bitboard_frame> bitboard_frame::get_next_boards(frame_arena& arena){
+    arena_list<bitboard_frame> next_boards{arena, MAX_NEXT_BOARDS};
+    fill_next_boards(*this, next_boards);
+    return next_boards.finish();
+}
 
+std::vector<bitboard_frame> bitboard_frame::get_opponent_next_boards(){
+    std::vector<bitboard_frame> next_boards;
+    fill_opponent_next_boards(*this, next_boards);
     return next_boards;
-}
\ No newline at end of file
+}
+
+arena_span<bitboard_frame> bitboard_frame::get_opponent_next_boards(frame_arena& arena){
+    arena_list<bitboard_frame> next_boards{arena, MAX_NEXT_BOARDS};
+    fill_opponent_next_boards(*this, next_boards);
+    return next_boards.finish();
+}
+
+size_t bitboard_frame::get_captures(size_t side_offset, frame_move* moves) const{
+    auto other_side {side_offset == PLAYER_OFFSET? OPPONENT_OFFSET : PLAYER_OFFSET};
+    auto strike_move {side(other_side).occupancy};
+    size_t count{0};
+
+    //pawns, with the generators' strike masks
+    auto pawns {side(side_offset).pieces[PAWN_OFFSET]};
+    auto forward {side_offset == PLAYER_OFFSET};
+    uint64_t strikes[2] {
+        (forward? (pawns&MASK_OFF_LEFT)<<9 : (pawns&MASK_OFF_RIGHT)>>9) & strike_move,
+        (forward? (pawns&MASK_OFF_RIGHT)<<7 : (pawns&MASK_OFF_LEFT)>>7) & strike_move
+    };
+    int strike_dist[2] {forward? 9 : -9, forward? 7 : -7};
+    for(size_t s=0; s<2; ++s){
+        while(strikes[s]){
+            auto to {(size_t)__builtin_ctzll(strikes[s])};
+            moves[count++] = frame_move{to-strike_dist[s], to, PAWN_OFFSET, NO_PIECE_OFFSET, true};
+            strikes[s] &= strikes[s]-1;
+        }
+    }
+
+    //rooks
+    auto rooks {side(side_offset).pieces[ROOK_OFFSET]};
+    while(rooks){
+        auto from {(size_t)__builtin_ctzll(rooks)};
+        auto targets {rook_attacks(from, occupied) & strike_move};
+        while(targets){
+            moves[count++] = frame_move{from, (size_t)__builtin_ctzll(targets), ROOK_OFFSET, NO_PIECE_OFFSET, true};
+            targets &= targets-1;
+        }
+        rooks &= rooks-1;
+    }
+    return count;
+}
@@ -1,10 +1,42 @@
-#include<cstdint>
-#include<cstddef> 
-#include<cstring>
-
-struct compressed_board{
-    uint8_t data[32]; 
-    compressed_board(uint8_t& data){
-        std::memcpy(this->data, &data, sizeof(data));
+#include "compressed_board.h"
+
+#include <cstring>
+
+namespace{
+const uint8_t OPPONENT_NIBBLE = 8;
+}
+
+compressed_board::compressed_board(const bitboard_frame& frame){
+    for(size_t side=0; side<SIDES; ++side){
+        for(size_t piece=0; piece<PIECE_TYPES; ++piece){
+            auto board {frame.side(side).pieces[piece]};
+            uint8_t nibble {(uint8_t)(piece + 1 + (side == OPPONENT_OFFSET? OPPONENT_NIBBLE : 0))};
+            while(board){
+                auto position {(size_t)__builtin_ctzll(board)};
+                data[position/2] |= nibble << (4*(position%2));
+                board &= board-1;
+            }
+        }
     }
-};
\ No newline at end of file
+}
+
+uint8_t compressed_board::square(size_t position) const{
+    return (data[position/2] >> (4*(position%2))) & 0xF;
+}
+
+bitboard_frame compressed_board::to_frame() const{
+    auto frame {bitboard_frame::empty()};
+    for(size_t position=0; position<BOARDSIZE*BOARDSIZE; ++position){
+        auto nibble {square(position)};
+        if(nibble == 0){
+            continue;
+        }
+        auto side {nibble & OPPONENT_NIBBLE? OPPONENT_OFFSET : PLAYER_OFFSET};
+        frame.add_piece(side, (nibble & ~OPPONENT_NIBBLE) - 1, position);
+    }
+    return frame;
+}
+
+bool compressed_board::operator==(const compressed_board& other) const{
+    return std::memcmp(data, other.data, COMPRESSED_BOARD_SIZE) == 0;
+}
@@ -0,0 +1,106 @@
+#include "engine_stats.h"
+
+#include <algorithm>
+#include <mutex>
+#include <vector>
+
+namespace{
+struct stats_registry{
+    std::mutex lock;
+    std::vector<engine_stats*> live;
+    engine_stats_snapshot retired;
+};
+
+stats_registry& registry(){
+    static stats_registry instance;
+    return instance;
+}
+
+void add_counter(uint64_t& total, const stat_counter& counter){
+    total += counter.get();
+}
+
+void reset_counter(stat_counter& counter){
+    counter.value.store(0, std::memory_order_relaxed);
+}
+}
+
+double engine_stats_snapshot::branching_factor() const{
+    return generation_calls? (double)generated_boards / generation_calls : 0.0;
+}
+
+double engine_stats_snapshot::tt_hit_rate() const{
+    return tt_probes? (double)tt_hits / tt_probes : 0.0;
+}
+
+double engine_stats_snapshot::first_move_cutoff_rate() const{
+    uint64_t total{0};
+    for(auto count : cutoffs){
+        total += count;
+    }
+    return total? (double)cutoffs[0] / total : 0.0;
+}
+
+engine_stats::engine_stats(){
+    auto& reg {registry()};
+    std::lock_guard<std::mutex> guard{reg.lock};
+    reg.live.push_back(this);
+}
+
+engine_stats::~engine_stats(){
+    auto& reg {registry()};
+    std::lock_guard<std::mutex> guard{reg.lock};
+    add_to(reg.retired);
+    reg.live.erase(std::remove(reg.live.begin(), reg.live.end(), this), reg.live.end());
+}
+
+void engine_stats::add_to(engine_stats_snapshot& total) const{
+    add_counter(total.nodes, nodes);
+    add_counter(total.qnodes, qnodes);
+    add_counter(total.tt_probes, tt_probes);
+    add_counter(total.tt_hits, tt_hits);
+    for(size_t i=0; i<STATS_CUTOFF_SLOTS; ++i){
+        add_counter(total.cutoffs[i], cutoffs[i]);
+    }
+    add_counter(total.generation_calls, generation_calls);
+    add_counter(total.generated_boards, generated_boards);
+    for(size_t i=0; i<=STATS_PIECE_SLOTS; ++i){
+        add_counter(total.generation_ns[i], generation_ns[i]);
+    }
+}
+
+engine_stats& thread_engine_stats(){
+    thread_local engine_stats stats;
+    return stats;
+}
+
+engine_stats_snapshot aggregate_engine_stats(){
+    auto& reg {registry()};
+    std::lock_guard<std::mutex> guard{reg.lock};
+    auto total {reg.retired};
+    for(auto stats : reg.live){
+        stats->add_to(total);
+    }
+    return total;
+}
+
+void reset_engine_stats(){
+    auto& reg {registry()};
+    std::lock_guard<std::mutex> guard{reg.lock};
+    reg.retired = engine_stats_snapshot{};
+    for(auto stats : reg.live){
+        auto& counters {*stats};
+        reset_counter(counters.nodes);
+        reset_counter(counters.qnodes);
+        reset_counter(counters.tt_probes);
+        reset_counter(counters.tt_hits);
+        for(auto& counter : counters.cutoffs){
+            reset_counter(counter);
+        }
+        reset_counter(counters.generation_calls);
+        reset_counter(counters.generated_boards);
+        for(auto& counter : counters.generation_ns){
+            reset_counter(counter);
+        }
+    }
+}
@@ -0,0 +1,31 @@
+#include "frame_arena.h"
+
+#include <cstdlib>
+
+frame_arena::frame_arena(size_t capacity): capacity{capacity} {
+    data = static_cast<unsigned char*>(std::aligned_alloc(64, (capacity+63) & ~(size_t)63));
+    if(!data){
+        throw std::bad_alloc();
+    }
+}
+
+frame_arena::~frame_arena(){
+    std::free(data);
+}
+
+void* frame_arena::allocate(size_t bytes, size_t alignment){
+    auto start {(used + alignment-1) & ~(alignment-1)};
+    if(start + bytes > capacity){
+        throw std::bad_alloc();
+    }
+    used = start + bytes;
+    if(used > peak){
+        peak = used;
+    }
+    return data + start;
+}
+
+frame_arena& thread_frame_arena(){
+    thread_local frame_arena arena;
+    return arena;
+}
@@ -0,0 +1,176 @@
+#include "frame_batch.h"
+#include "engine_stats.h"
+
+#include <cstring>
+
+namespace{
+// GCC/Clang vector extension: SSE2 pairs on a baseline x86-64 build, one
+// AVX2 register when built with -mavx2.
+typedef uint64_t lane_board __attribute__((vector_size(BATCH_LANES*sizeof(uint64_t))));
+
+const uint64_t PLAYER_DOUBLE_ROW = 0x0000000000FF0000;    //single pushes that may push again
+const uint64_t OPPONENT_DOUBLE_ROW = 0x0000FF0000000000;
+const size_t RAY_DIRECTIONS = 4;
+const size_t RAY_STEPS = 7;
+const int RAY_STEP_DISTANCE[RAY_DIRECTIONS] = {8, -8, 1, -1};
+
+struct lane_masks{
+    lane_board push;
+    lane_board double_push;
+    lane_board strike_left;
+    lane_board strike_right;
+    lane_board rays[RAY_DIRECTIONS][RAY_STEPS];
+};
+
+// Writes through lane so no vector crosses a call boundary, which would
+// change the ABI when AVX is not enabled.
+void load_lanes(const std::vector<uint64_t>& board, size_t start, size_t lanes, lane_board& lane){
+    lane = lane_board{};
+    std::memcpy(&lane, board.data()+start, lanes*sizeof(uint64_t));
+}
+
+template<bool PLAYER>
+void compute_masks(const frame_batch& batch, size_t start, size_t lanes, lane_masks& masks){
+    auto& own {batch.boards[PLAYER? PLAYER_OFFSET : OPPONENT_OFFSET]};
+    auto& other {batch.boards[PLAYER? OPPONENT_OFFSET : PLAYER_OFFSET]};
+
+    lane_board self_board{};
+    lane_board opp_board{};
+    lane_board loaded;
+    for(size_t piece=0; piece<6; ++piece){
+        load_lanes(own[piece], start, lanes, loaded);
+        self_board |= loaded;
+        load_lanes(other[piece], start, lanes, loaded);
+        opp_board |= loaded;
+    }
+    auto strike_move {~self_board&opp_board};
+    auto nonstrike_move {~self_board&~opp_board};
+
+    //pawns
+    lane_board pawns;
+    load_lanes(own[PAWN_OFFSET], start, lanes, pawns);
+    if constexpr(PLAYER){
+        masks.push = (pawns<<8)&nonstrike_move;
+        masks.double_push = ((masks.push&PLAYER_DOUBLE_ROW)<<8)&nonstrike_move;
+        masks.strike_left = ((pawns&MASK_OFF_LEFT)<<9)&strike_move;
+        masks.strike_right = ((pawns&MASK_OFF_RIGHT)<<7)&strike_move;
+    }
+    else{
+        masks.push = (pawns>>8)&nonstrike_move;
+        masks.double_push = ((masks.push&OPPONENT_DOUBLE_ROW)>>8)&nonstrike_move;
+        masks.strike_left = ((pawns&MASK_OFF_RIGHT)>>9)&strike_move;
+        masks.strike_right = ((pawns&MASK_OFF_LEFT)>>7)&strike_move;
+    }
+
+    //rooks: every lane walks all seven steps, empty lanes just stay zero
+    lane_board rooks;
+    load_lanes(own[ROOK_OFFSET], start, lanes, rooks);
+    auto cur_rooks {rooks};
+    for(size_t step=0; step<RAY_STEPS; ++step){
+        cur_rooks <<= 8;
+        masks.rays[0][step] = cur_rooks&~self_board;
+        cur_rooks &= nonstrike_move;
+    }
+    cur_rooks = rooks;
+    for(size_t step=0; step<RAY_STEPS; ++step){
+        cur_rooks >>= 8;
+        masks.rays[1][step] = cur_rooks&~self_board;
+        cur_rooks &= nonstrike_move;
+    }
+    cur_rooks = rooks;
+    for(size_t step=0; step<RAY_STEPS; ++step){
+        cur_rooks = (cur_rooks&MASK_OFF_LEFT)<<1;
+        masks.rays[2][step] = cur_rooks&~self_board;
+        cur_rooks &= nonstrike_move;
+    }
+    cur_rooks = rooks;
+    for(size_t step=0; step<RAY_STEPS; ++step){
+        cur_rooks = (cur_rooks&MASK_OFF_RIGHT)>>1;
+        masks.rays[3][step] = cur_rooks&~self_board;
+        cur_rooks &= nonstrike_move;
+    }
+}
+
+template<bool PLAYER>
+void emit_moves(bitboard_frame& frame, uint64_t targets, int distance, size_t struct_offset, bool strike, std::vector<bitboard_frame>& out){
+    while(targets){
+        auto to_position {(size_t)__builtin_ctzll(targets)};
+        targets &= targets-1;
+        auto from_position {(size_t)((int)to_position - distance)};
+        if constexpr(PLAYER){
+            out.emplace_back(frame.clone_from_player_move(struct_offset, from_position, to_position));
+            if(strike) out.back().remove_pieces(OPPONENT_OFFSET, to_position);
+        }
+        else{
+            out.emplace_back(frame.clone_from_opponent_move(struct_offset, from_position, to_position));
+            if(strike) out.back().remove_pieces(PLAYER_OFFSET, to_position);
+        }
+    }
+}
+
+template<bool PLAYER>
+void fill_batch(const frame_batch& batch, successor_batch& out){
+    auto forward {PLAYER? 8 : -8};
+    lane_masks masks;
+    for(size_t start=0; start<batch.size(); start+=BATCH_LANES){
+        auto lanes {batch.size()-start < BATCH_LANES? batch.size()-start : BATCH_LANES};
+        compute_masks<PLAYER>(batch, start, lanes, masks);
+
+        for(size_t lane=0; lane<lanes; ++lane){
+            auto frame {batch.frame_at(start+lane)};
+            emit_moves<PLAYER>(frame, masks.push[lane], forward, PAWN_OFFSET, false, out.boards);
+            emit_moves<PLAYER>(frame, masks.double_push[lane], 2*forward, PAWN_OFFSET, false, out.boards);
+            emit_moves<PLAYER>(frame, masks.strike_left[lane], forward+(PLAYER? 1 : -1), PAWN_OFFSET, true, out.boards);
+            emit_moves<PLAYER>(frame, masks.strike_right[lane], forward+(PLAYER? -1 : 1), PAWN_OFFSET, true, out.boards);
+            for(size_t direction=0; direction<RAY_DIRECTIONS; ++direction){
+                for(size_t step=0; step<RAY_STEPS; ++step){
+                    emit_moves<PLAYER>(frame, masks.rays[direction][step][lane], RAY_STEP_DISTANCE[direction]*(int)(step+1), ROOK_OFFSET, true, out.boards);
+                }
+            }
+            out.offsets.push_back(out.boards.size());
+        }
+    }
+}
+}
+
+void frame_batch::clear(){
+    for(auto& side : boards){
+        for(auto& board : side){
+            board.clear();
+        }
+    }
+}
+
+void frame_batch::push_back(const bitboard_frame& frame){
+    for(size_t side=0; side<SIDES; ++side){
+        for(size_t piece=0; piece<PIECE_TYPES; ++piece){
+            boards[side][piece].push_back(frame.side(side).pieces[piece]);
+        }
+    }
+}
+
+bitboard_frame frame_batch::frame_at(size_t index) const{
+    auto frame {bitboard_frame::empty()};
+    for(size_t side=0; side<SIDES; ++side){
+        for(size_t piece=0; piece<PIECE_TYPES; ++piece){
+            frame.side(side).pieces[piece] = boards[side][piece][index];
+            frame.side(side).occupancy |= frame.side(side).pieces[piece];
+        }
+    }
+    frame.occupied = frame.player.occupancy | frame.opponent.occupancy;
+    return frame;
+}
+
+void get_next_boards_batch(const frame_batch& batch, bool player_to_move, successor_batch& out){
+    out.boards.clear();
+    out.offsets.clear();
+    out.offsets.push_back(0);
+    if(player_to_move){
+        fill_batch<true>(batch, out);
+    }
+    else{
+        fill_batch<false>(batch, out);
+    }
+    STATS_ADD(generation_calls, batch.size());
+    STATS_ADD(generated_boards, out.boards.size());
+}
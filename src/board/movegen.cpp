@@ -0,0 +1,209 @@
+#include "movegen.h"
+#include "attacks.h"
+#include "engine_stats.h"
+
+namespace{
+const size_t PROMOTIONS[4] {QUEEN_OFFSET, ROOK_OFFSET, BISHOP_OFFSET, KNIGHT_OFFSET};
+
+struct castle_rule{
+    uint8_t right;
+    size_t king_from;
+    size_t king_to;
+    size_t rook_from;
+    uint64_t between;       // must be empty
+};
+
+const castle_rule CASTLE_RULES[4] {
+    {CASTLE_WHITE_KING, 4, 6, 7, (uint64_t)0x60},
+    {CASTLE_WHITE_QUEEN, 4, 2, 0, (uint64_t)0x0E},
+    {CASTLE_BLACK_KING, 60, 62, 63, (uint64_t)0x60<<56},
+    {CASTLE_BLACK_QUEEN, 60, 58, 56, (uint64_t)0x0E<<56},
+};
+
+size_t add_targets(frame_move* moves, size_t count, size_t piece, size_t from, uint64_t targets, uint64_t enemy){
+    while(targets){
+        auto to {(size_t)__builtin_ctzll(targets)};
+        moves[count++] = frame_move{from, to, piece, NO_PIECE_OFFSET, ((enemy>>to)&1) != 0};
+        targets &= targets-1;
+    }
+    return count;
+}
+
+size_t add_pawn_move(frame_move* moves, size_t count, size_t from, size_t to, bool capture){
+    if(to < BOARDSIZE || to >= BOARDSIZE*(BOARDSIZE-1)){
+        for(auto promotion : PROMOTIONS){
+            moves[count++] = frame_move{from, to, PAWN_OFFSET, promotion, capture};
+        }
+        return count;
+    }
+    moves[count++] = frame_move{from, to, PAWN_OFFSET, NO_PIECE_OFFSET, capture};
+    return count;
+}
+
+uint8_t castling_lost(size_t square){
+    switch(square){
+        case 0: return CASTLE_WHITE_QUEEN;
+        case 4: return CASTLE_WHITE_KING | CASTLE_WHITE_QUEEN;
+        case 7: return CASTLE_WHITE_KING;
+        case 56: return CASTLE_BLACK_QUEEN;
+        case 60: return CASTLE_BLACK_KING | CASTLE_BLACK_QUEEN;
+        case 63: return CASTLE_BLACK_KING;
+    }
+    return 0;
+}
+}
+
+size_t generate_moves(const bitboard_frame& frame, const position_state& state, frame_move* moves){
+    STATS_INC(generation_calls);
+    auto side {state.player_to_move? PLAYER_OFFSET : OPPONENT_OFFSET};
+    auto other_side {state.player_to_move? OPPONENT_OFFSET : PLAYER_OFFSET};
+    auto own {frame.side(side).occupancy};
+    auto enemy {frame.side(other_side).occupancy};
+    auto empty {~frame.occupied};
+    auto& pieces {frame.side(side).pieces};
+    size_t count{0};
+
+    //pawns
+    int forward {state.player_to_move? (int)BOARDSIZE : -(int)BOARDSIZE};
+    auto start_row {state.player_to_move? 1 : 6};
+    uint64_t en_passant {state.en_passant < NO_SQUARE? (uint64_t)1<<state.en_passant : 0};
+    auto pawns {pieces[PAWN_OFFSET]};
+    while(pawns){
+        auto from {(size_t)__builtin_ctzll(pawns)};
+        auto one {(size_t)((int)from + forward)};
+        if((empty>>one)&1){
+            count = add_pawn_move(moves, count, from, one, false);
+            auto two {(size_t)((int)one + forward)};
+            if((int)(from/BOARDSIZE) == start_row && (empty>>two)&1){
+                moves[count++] = frame_move{from, two, PAWN_OFFSET, NO_PIECE_OFFSET, false};
+            }
+        }
+        auto strikes {pawn_attacks(side, (uint64_t)1<<from) & (enemy | en_passant)};
+        while(strikes){
+            count = add_pawn_move(moves, count, from, (size_t)__builtin_ctzll(strikes), true);
+            strikes &= strikes-1;
+        }
+        pawns &= pawns-1;
+    }
+
+    //knights, sliders and king
+    for(auto piece : {KNIGHT_OFFSET, BISHOP_OFFSET, ROOK_OFFSET, QUEEN_OFFSET, KING_OFFSET}){
+        auto board {pieces[piece]};
+        while(board){
+            auto from {(size_t)__builtin_ctzll(board)};
+            uint64_t targets{0};
+            switch(piece){
+                case KNIGHT_OFFSET: targets = knight_attacks((uint64_t)1<<from); break;
+                case BISHOP_OFFSET: targets = bishop_attacks(from, frame.occupied); break;
+                case ROOK_OFFSET: targets = rook_attacks(from, frame.occupied); break;
+                case QUEEN_OFFSET: targets = bishop_attacks(from, frame.occupied) | rook_attacks(from, frame.occupied); break;
+                case KING_OFFSET: targets = king_attacks((uint64_t)1<<from); break;
+            }
+            count = add_targets(moves, count, piece, from, targets & ~own, enemy);
+            board &= board-1;
+        }
+    }
+
+    //castling, safety of the squares is left to is_legal
+    for(auto& rule : CASTLE_RULES){
+        if(!(state.castling & rule.right) || (rule.king_from < 8) != state.player_to_move){
+            continue;
+        }
+        if(((pieces[KING_OFFSET]>>rule.king_from)&1) && ((pieces[ROOK_OFFSET]>>rule.rook_from)&1) && !(frame.occupied & rule.between)){
+            moves[count++] = frame_move{rule.king_from, rule.king_to, KING_OFFSET, NO_PIECE_OFFSET, false};
+        }
+    }
+    STATS_ADD(generated_boards, count);
+    return count;
+}
+
+bool square_attacked(const bitboard_frame& frame, size_t square, size_t by_side_offset){
+    return (attackers_to(frame, square, frame.occupied) & frame.side(by_side_offset).occupancy) != 0;
+}
+
+bool in_check(const bitboard_frame& frame, size_t side_offset){
+    auto king {frame.side(side_offset).pieces[KING_OFFSET]};
+    auto other_side {side_offset == PLAYER_OFFSET? OPPONENT_OFFSET : PLAYER_OFFSET};
+    return king && square_attacked(frame, (size_t)__builtin_ctzll(king), other_side);
+}
+
+bool is_legal(const bitboard_frame& frame, const position_state& state, const frame_move& move){
+    auto side {state.player_to_move? PLAYER_OFFSET : OPPONENT_OFFSET};
+    auto other_side {state.player_to_move? OPPONENT_OFFSET : PLAYER_OFFSET};
+    if(move.piece_offset == KING_OFFSET && (move.from_position == move.to_position+2 || move.to_position == move.from_position+2)){
+        if(square_attacked(frame, move.from_position, other_side) || square_attacked(frame, (move.from_position+move.to_position)/2, other_side)){
+            return false;
+        }
+    }
+    auto next {frame.clone_from_played_move(side, move.from_position, move.to_position, move.promotion_offset)};
+    return !in_check(next, side);
+}
+
+bool is_legal(const bitboard_frame& frame, const position_state& state, const frame_move& move, const attack_map& map){
+    auto side {state.player_to_move? PLAYER_OFFSET : OPPONENT_OFFSET};
+    auto other_side {state.player_to_move? OPPONENT_OFFSET : PLAYER_OFFSET};
+    auto from_mask {(uint64_t)1<<move.from_position};
+    if(move.piece_offset == KING_OFFSET){
+        if(map.is_attacked(other_side, move.to_position)){
+            return false;
+        }
+        if(move.from_position == move.to_position+2 || move.to_position == move.from_position+2){
+            return !map.is_attacked(other_side, move.from_position) && !map.is_attacked(other_side, (move.from_position+move.to_position)/2);
+        }
+        // a slider checking the king would still reach squares behind it
+        if(!(map.slider_attacked[other_side] & from_mask)){
+            return true;
+        }
+    }
+    else if(!map.in_check(frame, side) && !(map.slider_attacked[other_side] & from_mask)
+        && !(move.piece_offset == PAWN_OFFSET && move.to_position == state.en_passant)){
+        // nothing can be pinned to the king without an enemy slider reaching it
+        return true;
+    }
+    return is_legal(frame, state, move);
+}
+
+void make_move(bitboard_frame& frame, position_state& state, const frame_move& move){
+    auto side {state.player_to_move? PLAYER_OFFSET : OPPONENT_OFFSET};
+    frame = frame.clone_from_played_move(side, move.from_position, move.to_position, move.promotion_offset);
+    state.castling &= ~(castling_lost(move.from_position) | castling_lost(move.to_position));
+    auto double_push {move.piece_offset == PAWN_OFFSET && (move.from_position == move.to_position+2*BOARDSIZE || move.to_position == move.from_position+2*BOARDSIZE)};
+    state.en_passant = double_push? (move.from_position+move.to_position)/2 : NO_SQUARE;
+    state.player_to_move = !state.player_to_move;
+}
+
+void make_move(bitboard_frame& frame, position_state& state, const frame_move& move, attack_map& map){
+    auto before {frame};
+    make_move(frame, state, move);
+    map.update(before, frame);
+}
+
+namespace{
+uint64_t perft_with_map(const bitboard_frame& frame, const position_state& state, const attack_map& map, size_t depth){
+    frame_move moves[MAX_MOVES];
+    auto count {generate_moves(frame, state, moves)};
+    uint64_t leaves{0};
+    for(size_t i=0; i<count; ++i){
+        if(!is_legal(frame, state, moves[i], map)){
+            continue;
+        }
+        if(depth == 1){
+            ++leaves;
+            continue;
+        }
+        auto next {frame};
+        auto next_state {state};
+        auto next_map {map};
+        make_move(next, next_state, moves[i], next_map);
+        leaves += perft_with_map(next, next_state, next_map, depth-1);
+    }
+    return leaves;
+}
+}
+
+uint64_t perft(const bitboard_frame& frame, const position_state& state, size_t depth){
+    if(depth == 0){
+        return 1;
+    }
+    return perft_with_map(frame, state, attack_map{frame}, depth);
+}
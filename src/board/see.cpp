@@ -0,0 +1,66 @@
+#include "see.h"
+#include "attacks.h"
+
+namespace{
+const size_t SEE_MAX_SWAPS = 32;
+// attackers are spent cheapest first
+const size_t ATTACKER_ORDER[PIECE_TYPES] {PAWN_OFFSET, KNIGHT_OFFSET, BISHOP_OFFSET, ROOK_OFFSET, QUEEN_OFFSET, KING_OFFSET};
+
+int32_t see_value(size_t piece, const int32_t* piece_values){
+    if(piece == NO_PIECE_OFFSET){
+        return 0;
+    }
+    return piece == KING_OFFSET? SEE_KING_VALUE : piece_values[piece];
+}
+}
+
+int32_t static_exchange(const bitboard_frame& frame, size_t side_offset, size_t from_position, size_t to_position, const int32_t* piece_values){
+    auto other_side {side_offset == PLAYER_OFFSET? OPPONENT_OFFSET : PLAYER_OFFSET};
+    auto piece {frame.piece_at(side_offset, from_position)};
+    if(piece == NO_PIECE_OFFSET){
+        return 0;
+    }
+
+    auto straight {frame.player.pieces[ROOK_OFFSET] | frame.player.pieces[QUEEN_OFFSET]
+        | frame.opponent.pieces[ROOK_OFFSET] | frame.opponent.pieces[QUEEN_OFFSET]};
+    auto diagonal {frame.player.pieces[BISHOP_OFFSET] | frame.player.pieces[QUEEN_OFFSET]
+        | frame.opponent.pieces[BISHOP_OFFSET] | frame.opponent.pieces[QUEEN_OFFSET]};
+    auto occupied {frame.occupied};
+    auto attackers {attackers_to(frame, to_position, occupied)};
+    uint64_t from_bit {(uint64_t)1<<from_position};
+
+    // gain[d] is what the side making capture d nets if the exchange stops after it
+    int32_t gain[SEE_MAX_SWAPS];
+    size_t depth{0};
+    gain[0] = see_value(frame.piece_at(other_side, to_position), piece_values);
+    auto side {side_offset};
+    while(depth+1 < SEE_MAX_SWAPS){
+        ++depth;
+        gain[depth] = see_value(piece, piece_values) - gain[depth-1];
+
+        occupied &= ~from_bit;
+        attackers &= ~from_bit;
+        // x-rays: sliders behind the piece that just left now see the square
+        attackers |= (rook_attacks(to_position, occupied) & straight) | (bishop_attacks(to_position, occupied) & diagonal);
+        attackers &= occupied;
+
+        side = side == PLAYER_OFFSET? OPPONENT_OFFSET : PLAYER_OFFSET;
+        from_bit = 0;
+        for(auto candidate : ATTACKER_ORDER){
+            auto boards {attackers & frame.side(side).pieces[candidate]};
+            if(boards){
+                from_bit = boards & (~boards+1);
+                piece = candidate;
+                break;
+            }
+        }
+        if(!from_bit){
+            break;
+        }
+    }
+
+    while(--depth){
+        gain[depth-1] = -(-gain[depth-1] > gain[depth]? -gain[depth-1] : gain[depth]);
+    }
+    return gain[0];
+}
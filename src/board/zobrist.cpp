@@ -0,0 +1,92 @@
+#include "zobrist.h"
+#include "attacks.h"
+
+#include <fstream>
+
+namespace{
+uint64_t splitmix64(uint64_t& state){
+    uint64_t z {(state += 0x9E3779B97F4A7C15)};
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EB;
+    return z ^ (z >> 31);
+}
+
+uint64_t hash_pieces(uint64_t board, size_t kind, const zobrist_keys& keys){
+    uint64_t hash{0};
+    while(board){
+        auto position {(size_t)__builtin_ctzll(board)};
+        hash ^= keys.keys[kind*64 + position];
+        board &= board-1;
+    }
+    return hash;
+}
+
+uint64_t hash_side(const bitboard_frame& frame, size_t side_offset, const zobrist_keys& keys){
+    uint64_t hash{0};
+    for(size_t piece=0; piece<PIECE_TYPES; ++piece){
+        hash ^= hash_pieces(frame.side(side_offset).pieces[piece], zobrist_piece_kind(side_offset, piece), keys);
+    }
+    return hash;
+}
+}
+
+zobrist_keys::zobrist_keys(uint64_t seed){
+    for(size_t i=0; i<ZOBRIST_KEY_COUNT; ++i){
+        keys[i] = splitmix64(seed);
+    }
+}
+
+bool zobrist_keys::load(const char* path){
+    std::ifstream in(path, std::ios::binary);
+    uint64_t loaded[ZOBRIST_KEY_COUNT];
+    if(!in.read(reinterpret_cast<char*>(loaded), sizeof(loaded))){
+        return false;
+    }
+    for(size_t i=0; i<ZOBRIST_KEY_COUNT; ++i){
+        keys[i] = loaded[i];
+    }
+    return true;
+}
+
+zobrist_keys& zobrist_keys::defaults(){
+    static zobrist_keys keys;
+    return keys;
+}
+
+zobrist_keys& zobrist_keys::polyglot(){
+    static zobrist_keys keys{[](){
+        zobrist_keys table;
+        for(size_t i=0; i<ZOBRIST_KEY_COUNT; ++i){
+            table.keys[i] = POLYGLOT_RANDOM64[i];
+        }
+        return table;
+    }()};
+    return keys;
+}
+
+uint64_t zobrist_hash(const bitboard_frame& frame, bool player_to_move, const zobrist_keys& keys){
+    auto hash {hash_side(frame, PLAYER_OFFSET, keys) ^ hash_side(frame, OPPONENT_OFFSET, keys)};
+    if(player_to_move){
+        hash ^= keys.keys[ZOBRIST_TURN_OFFSET];
+    }
+    return hash;
+}
+
+uint64_t zobrist_hash(const bitboard_frame& frame, const position_state& state, const zobrist_keys& keys){
+    auto hash {zobrist_hash(frame, state.player_to_move, keys)};
+    // castling bits are in Polyglot key order: white short, white long, black short, black long
+    for(size_t right=0; right<4; ++right){
+        if(state.castling & (1<<right)){
+            hash ^= keys.keys[ZOBRIST_CASTLE_OFFSET + right];
+        }
+    }
+    if(state.en_passant < NO_SQUARE){
+        auto side {state.player_to_move? PLAYER_OFFSET : OPPONENT_OFFSET};
+        auto other_side {state.player_to_move? OPPONENT_OFFSET : PLAYER_OFFSET};
+        // the squares a capturing pawn could stand on attack the passed square from the other side
+        if(pawn_attacks(other_side, (uint64_t)1<<state.en_passant) & frame.side(side).pieces[PAWN_OFFSET]){
+            hash ^= keys.keys[ZOBRIST_EN_PASSANT_OFFSET + state.en_passant%BOARDSIZE];
+        }
+    }
+    return hash;
+}
@@ -0,0 +1,150 @@
+#include "analysis.h"
+#include "bounded_queue.h"
+#include "notation.h"
+
+#include <chrono>
+#include <cstdio>
+#include <istream>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace{
+const size_t EPD_POSITION_FIELDS = 4;
+const size_t JOBS_PER_THREAD = 4;
+
+std::string json_string(const std::string& text){
+    std::string quoted {"\""};
+    for(auto c : text){
+        switch(c){
+            case '"': quoted += "\\\""; break;
+            case '\\': quoted += "\\\\"; break;
+            case '\n': quoted += "\\n"; break;
+            case '\t': quoted += "\\t"; break;
+            default:
+                if((unsigned char)c < 0x20){
+                    char escaped[8];
+                    snprintf(escaped, sizeof(escaped), "\\u%04x", (unsigned)c);
+                    quoted += escaped;
+                }
+                else{
+                    quoted += c;
+                }
+        }
+    }
+    return quoted + "\"";
+}
+
+std::string epd_id(const std::string& line){
+    auto op {line.find("id \"")};
+    if(op == std::string::npos){
+        return "";
+    }
+    auto start {op+4};
+    auto end {line.find('"', start)};
+    return line.substr(start, end == std::string::npos? std::string::npos : end-start);
+}
+
+void job_fields(std::ostringstream& json, const analysis_job& job){
+    json<<"{\"index\":"<<job.index;
+    if(!job.id.empty()){
+        json<<",\"id\":"<<json_string(job.id);
+    }
+    json<<",\"fen\":"<<json_string(job.fen);
+}
+}
+
+bool parse_analysis_line(const std::string& line, size_t index, analysis_job& job){
+    auto first {line.find_first_not_of(" \t\r")};
+    if(first == std::string::npos || line[first] == '#'){
+        return false;
+    }
+
+    job = analysis_job{};
+    job.index = index;
+    job.id = epd_id(line);
+    // FEN and EPD share the first four fields, which is all the position needs
+    std::istringstream fields{line};
+    std::string field;
+    for(size_t i=0; i<EPD_POSITION_FIELDS && fields >> field; ++i){
+        job.fen += (i? " " : "") + field;
+    }
+    job.valid = parse_fen(line, job.frame, job.state);
+    return true;
+}
+
+std::string analysis_json(const analysis_job& job, const search_result& result, double milliseconds){
+    frame_move moves[MAX_MOVES];
+    auto count {generate_moves(job.frame, job.state, moves)};
+
+    std::ostringstream json;
+    job_fields(json, job);
+    json<<",\"bestmove\":"<<json_string(coordinate_move(result.move));
+    json<<",\"san\":"<<json_string(san_move(job.frame, job.state, result.move, moves, count));
+    json<<",\"score\":"<<result.score;
+    if(result.score > MATE_BOUND){
+        json<<",\"mate\":"<<(MATE_SCORE - result.score + 1)/2;
+    }
+    else if(result.score < -MATE_BOUND){
+        json<<",\"mate\":"<<-(MATE_SCORE + result.score)/2;
+    }
+    json<<",\"depth\":"<<result.depth;
+    json<<",\"nodes\":"<<result.nodes;
+    json<<",\"time_ms\":"<<(uint64_t)milliseconds<<"}";
+    return json.str();
+}
+
+std::string analysis_error_json(const analysis_job& job, const char* error){
+    std::ostringstream json;
+    job_fields(json, job);
+    json<<",\"error\":"<<json_string(error)<<"}";
+    return json.str();
+}
+
+size_t analyze_stream(std::istream& in, std::ostream& out, const analysis_options& options){
+    auto thread_count {options.threads? options.threads : 1};
+    bounded_queue<analysis_job> queue{options.queue_capacity? options.queue_capacity : JOBS_PER_THREAD*thread_count};
+    transposition_table table{options.hash_mb};
+    std::mutex output_lock;
+    size_t written{0};
+
+    auto worker = [&](){
+        searcher search{table, thread_frame_arena(), options.weights};
+        analysis_job job;
+        while(queue.pop(job)){
+            std::string line;
+            if(!job.valid){
+                line = analysis_error_json(job, "invalid position");
+            }
+            else{
+                auto started {std::chrono::steady_clock::now()};
+                auto result {search.search(job.frame, job.state, options.limits)};
+                auto elapsed {std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count()};
+                line = result.found? analysis_json(job, result, elapsed) : analysis_error_json(job, "no moves");
+            }
+            std::lock_guard<std::mutex> guard{output_lock};
+            out<<line<<std::endl;
+            ++written;
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for(size_t t=0; t<thread_count; ++t){
+        threads.emplace_back(worker);
+    }
+    std::string line;
+    size_t index{0};
+    while(std::getline(in, line)){
+        analysis_job job;
+        if(parse_analysis_line(line, ++index, job)){
+            queue.push(std::move(job));
+        }
+    }
+    queue.close();
+    for(auto& thread : threads){
+        thread.join();
+    }
+    return written;
+}
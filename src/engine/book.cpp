@@ -0,0 +1,256 @@
+#include "book.h"
+#include "zobrist.h"
+
+#include <fcntl.h>
+#include <fstream>
+#include <sstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace{
+const size_t BOOK_PROBE_LIMIT = 64;
+
+uint64_t read_big_endian(const unsigned char* data, size_t bytes){
+    uint64_t value{0};
+    for(size_t i=0; i<bytes; ++i){
+        value = (value<<8) | data[i];
+    }
+    return value;
+}
+
+void write_big_endian(std::ostream& out, uint64_t value, size_t bytes){
+    for(size_t i=bytes; i>0; --i){
+        out.put((char)((value >> (8*(i-1))) & 0xFF));
+    }
+}
+
+size_t promotion_from_polyglot(uint16_t promotion){
+    switch(promotion){
+        case 1: return KNIGHT_OFFSET;
+        case 2: return BISHOP_OFFSET;
+        case 3: return ROOK_OFFSET;
+        case 4: return QUEEN_OFFSET;
+    }
+    return NO_PIECE_OFFSET;
+}
+
+uint16_t promotion_to_polyglot(size_t promotion_offset){
+    switch(promotion_offset){
+        case KNIGHT_OFFSET: return 1;
+        case BISHOP_OFFSET: return 2;
+        case ROOK_OFFSET: return 3;
+        case QUEEN_OFFSET: return 4;
+    }
+    return 0;
+}
+
+bool parse_coordinate_move(const std::string& token, size_t& from_position, size_t& to_position, size_t& promotion_offset){
+    if(token.size() < 4 || token.size() > 5){
+        return false;
+    }
+    if(token[0] < 'a' || token[0] > 'h' || token[2] < 'a' || token[2] > 'h'){
+        return false;
+    }
+    if(token[1] < '1' || token[1] > '8' || token[3] < '1' || token[3] > '8'){
+        return false;
+    }
+    from_position = compute_distance(token[1]-'1', token[0]-'a');
+    to_position = compute_distance(token[3]-'1', token[2]-'a');
+    promotion_offset = NO_PIECE_OFFSET;
+    if(token.size() == 5){
+        switch(token[4]){
+            case 'n': promotion_offset = KNIGHT_OFFSET; break;
+            case 'b': promotion_offset = BISHOP_OFFSET; break;
+            case 'r': promotion_offset = ROOK_OFFSET; break;
+            case 'q': promotion_offset = QUEEN_OFFSET; break;
+            default: return false;
+        }
+    }
+    return true;
+}
+
+bool is_move_number(const std::string& token){
+    return !token.empty() && token.back() == '.';
+}
+}
+
+uint16_t encode_book_move(size_t from_position, size_t to_position, size_t promotion_offset, bool castling){
+    if(castling){
+        auto row_start {from_position - from_position%BOARDSIZE};
+        to_position = to_position > from_position? row_start+BOARDSIZE-1 : row_start;
+    }
+    return (uint16_t)(to_position | from_position<<6 | promotion_to_polyglot(promotion_offset)<<12);
+}
+
+book_move decode_book_move(uint16_t move, const bitboard_frame& frame, size_t side_offset){
+    book_move decoded;
+    decoded.to_position = move & 0x3F;
+    decoded.from_position = (move>>6) & 0x3F;
+    decoded.promotion_offset = promotion_from_polyglot((move>>12) & 0x7);
+    decoded.weight = 0;
+
+    if(frame.piece_at(side_offset, decoded.from_position) == KING_OFFSET && frame.piece_at(side_offset, decoded.to_position) == ROOK_OFFSET){
+        decoded.to_position = decoded.to_position > decoded.from_position? decoded.from_position+2 : decoded.from_position-2;
+    }
+    return decoded;
+}
+
+opening_book::~opening_book(){
+    close();
+}
+
+bool opening_book::open(const char* path){
+    close();
+    auto fd {::open(path, O_RDONLY)};
+    if(fd < 0){
+        return false;
+    }
+    struct stat info;
+    if(fstat(fd, &info) != 0 || info.st_size < (off_t)BOOK_ENTRY_SIZE){
+        ::close(fd);
+        return false;
+    }
+    auto mapped {mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0)};
+    ::close(fd);
+    if(mapped == MAP_FAILED){
+        return false;
+    }
+    // probes jump around the file, read-ahead would only evict other pages
+    madvise(mapped, info.st_size, MADV_RANDOM);
+
+    entries = static_cast<const unsigned char*>(mapped);
+    mapped_size = info.st_size;
+    entry_count = mapped_size / BOOK_ENTRY_SIZE;
+    return true;
+}
+
+void opening_book::close(){
+    if(entries){
+        munmap(const_cast<unsigned char*>(entries), mapped_size);
+    }
+    entries = nullptr;
+    entry_count = 0;
+    mapped_size = 0;
+}
+
+bool opening_book::is_open() const{
+    return entries != nullptr;
+}
+
+uint64_t opening_book::key_at(size_t index) const{
+    return read_big_endian(entries + index*BOOK_ENTRY_SIZE, 8);
+}
+
+size_t opening_book::probe(uint64_t key, uint16_t* moves, uint16_t* weights, size_t capacity) const{
+    size_t low{0};
+    size_t high{entry_count};
+    while(low < high){
+        auto mid {low + (high-low)/2};
+        if(key_at(mid) < key){
+            low = mid+1;
+        }
+        else{
+            high = mid;
+        }
+    }
+
+    size_t found{0};
+    for(auto i=low; i<entry_count && key_at(i) == key; ++i){
+        if(found < capacity){
+            auto entry {entries + i*BOOK_ENTRY_SIZE};
+            moves[found] = (uint16_t)read_big_endian(entry+8, 2);
+            weights[found] = (uint16_t)read_big_endian(entry+10, 2);
+        }
+        ++found;
+    }
+    return found;
+}
+
+bool opening_book::pick(const bitboard_frame& frame, const position_state& state, std::mt19937_64& rng, book_move& chosen) const{
+    if(!is_open()){
+        return false;
+    }
+    uint16_t moves[BOOK_PROBE_LIMIT];
+    uint16_t weights[BOOK_PROBE_LIMIT];
+    auto found {probe(zobrist_hash(frame, state), moves, weights, BOOK_PROBE_LIMIT)};
+    if(found > BOOK_PROBE_LIMIT){
+        found = BOOK_PROBE_LIMIT;
+    }
+
+    uint64_t total{0};
+    for(size_t i=0; i<found; ++i){
+        total += weights[i];
+    }
+    if(total == 0){
+        return false;
+    }
+
+    auto roll {std::uniform_int_distribution<uint64_t>(0, total-1)(rng)};
+    for(size_t i=0; i<found; ++i){
+        if(roll < weights[i]){
+            chosen = decode_book_move(moves[i], frame, state.player_to_move? PLAYER_OFFSET : OPPONENT_OFFSET);
+            chosen.weight = weights[i];
+            return true;
+        }
+        roll -= weights[i];
+    }
+    return false;
+}
+
+book_builder::book_builder(size_t max_ply): max_ply{max_ply} {}
+
+size_t book_builder::add_game(const std::string& line){
+    bitboard_frame frame;
+    position_state state;
+    std::istringstream tokens{line};
+    std::string token;
+    size_t ply{0};
+    while(ply < max_ply && tokens >> token){
+        if(is_move_number(token)){
+            continue;
+        }
+        size_t from_position, to_position, promotion_offset;
+        if(!parse_coordinate_move(token, from_position, to_position, promotion_offset)){
+            break;
+        }
+        auto side_offset {ply%2 == 0? PLAYER_OFFSET : OPPONENT_OFFSET};
+        auto piece {frame.piece_at(side_offset, from_position)};
+        if(piece == NO_PIECE_OFFSET){
+            break;
+        }
+
+        auto castling {piece == KING_OFFSET && (from_position == to_position+2 || to_position == from_position+2)};
+        ++counts[{zobrist_hash(frame, state), encode_book_move(from_position, to_position, promotion_offset, castling)}];
+        auto capture {frame.piece_at(side_offset == PLAYER_OFFSET? OPPONENT_OFFSET : PLAYER_OFFSET, to_position) != NO_PIECE_OFFSET};
+        make_move(frame, state, frame_move{from_position, to_position, piece, promotion_offset, capture});
+        ++ply;
+    }
+    return ply;
+}
+
+size_t book_builder::add_games(std::istream& in){
+    size_t games{0};
+    std::string line;
+    while(std::getline(in, line)){
+        if(add_game(line) > 0){
+            ++games;
+        }
+    }
+    return games;
+}
+
+bool book_builder::write(const char* path) const{
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if(!out){
+        return false;
+    }
+    // map order is (key, move), which is the sort order probes rely on
+    for(auto& [entry, count] : counts){
+        write_big_endian(out, entry.first, 8);
+        write_big_endian(out, entry.second, 2);
+        write_big_endian(out, count > 0xFFFF? 0xFFFF : count, 2);
+        write_big_endian(out, 0, 4);
+    }
+    return (bool)out;
+}
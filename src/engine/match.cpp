@@ -0,0 +1,291 @@
+#include "match.h"
+#include "notation.h"
+#include "zobrist.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <sstream>
+
+namespace{
+const size_t FIFTY_MOVE_PLIES = 100;
+
+// Neither side can mate: bare kings, or a single knight or bishop besides them.
+bool insufficient_material(const bitboard_frame& frame){
+    auto kings {frame.player.pieces[KING_OFFSET] | frame.opponent.pieces[KING_OFFSET]};
+    auto minors {frame.player.pieces[KNIGHT_OFFSET] | frame.player.pieces[BISHOP_OFFSET]
+        | frame.opponent.pieces[KNIGHT_OFFSET] | frame.opponent.pieces[BISHOP_OFFSET]};
+    return (frame.occupied & ~kings) == minors && __builtin_popcountll(minors) <= 1;
+}
+
+double expected_score(double elo){
+    return 1.0 / (1.0 + std::pow(10.0, -elo/400.0));
+}
+
+double elo_from_score(double score){
+    if(score <= 0.0) return -INFINITY;
+    if(score >= 1.0) return INFINITY;
+    return -400.0 * std::log10(1.0/score - 1.0);
+}
+
+struct outcome_frequencies{
+    double win;
+    double draw;
+    double loss;
+
+    double score() const { return win + 0.5*draw; }
+    double variance() const {
+        auto s {score()};
+        return win*(1-s)*(1-s) + draw*(0.5-s)*(0.5-s) + loss*s*s;
+    }
+};
+
+// Half a pseudo-game per outcome keeps the variance positive on one-sided
+// runs. The mean comes from the same frequencies as the variance.
+outcome_frequencies regularized(size_t wins, size_t draws, size_t losses){
+    auto n {wins + draws + losses + 1.5};
+    return {(wins+0.5)/n, (draws+0.5)/n, (losses+0.5)/n};
+}
+}
+
+bool parse_engine_config(const std::string& spec, engine_config& config){
+    std::istringstream items{spec};
+    std::string item;
+    while(std::getline(items, item, ',')){
+        if(item.empty()){
+            continue;
+        }
+        auto split {item.find('=')};
+        if(split == std::string::npos){
+            return false;
+        }
+        auto key {item.substr(0, split)};
+        auto value {item.substr(split+1)};
+        auto number {atoll(value.c_str())};
+        if(key == "name") config.name = value;
+        else if(key == "depth") config.limits.depth = (size_t)number;
+        else if(key == "nodes") config.limits.nodes = (uint64_t)number;
+        else if(key == "hash") config.hash_mb = (size_t)number;
+        else if(key == "pawn") config.weights.piece_values[PAWN_OFFSET] = (int32_t)number;
+        else if(key == "rook") config.weights.piece_values[ROOK_OFFSET] = (int32_t)number;
+        else if(key == "bishop") config.weights.piece_values[BISHOP_OFFSET] = (int32_t)number;
+        else if(key == "knight") config.weights.piece_values[KNIGHT_OFFSET] = (int32_t)number;
+        else if(key == "queen") config.weights.piece_values[QUEEN_OFFSET] = (int32_t)number;
+        else if(key == "advance") config.weights.pawn_advance = (int32_t)number;
+        else return false;
+    }
+    return true;
+}
+
+game_record play_game(const bitboard_frame& start, const position_state& start_state, const engine_config& white, const engine_config& black, const adjudication_rules& rules){
+    game_record game;
+    game.start_fen = to_fen(start, start_state);
+    game.white = white.name;
+    game.black = black.name;
+
+    transposition_table white_table{white.hash_mb};
+    transposition_table black_table{black.hash_mb};
+    auto& arena {thread_frame_arena()};
+    bitboard_frame frame{start};
+    auto state {start_state};
+    // keys since the last capture or pawn move, the only positions that can repeat
+    std::vector<uint64_t> history;
+    size_t quiet_plies{0};
+    size_t resign_count{0};
+    int resign_side{0};
+    size_t draw_count{0};
+    frame_move moves[MAX_MOVES];
+
+    for(size_t ply=0;; ++ply){
+        auto key {zobrist_hash(frame, state)};
+        history.push_back(key);
+        auto count {generate_moves(frame, state, moves)};
+        bool any_legal{false};
+        for(size_t i=0; i<count && !any_legal; ++i){
+            any_legal = is_legal(frame, state, moves[i]);
+        }
+        if(!any_legal){
+            if(in_check(frame, state.player_to_move? PLAYER_OFFSET : OPPONENT_OFFSET)){
+                game.result = state.player_to_move? GAME_BLACK_WIN : GAME_WHITE_WIN;
+                game.termination = "checkmate";
+            }
+            else{
+                game.result = GAME_DRAW;
+                game.termination = "stalemate";
+            }
+            break;
+        }
+        if(std::count(history.begin(), history.end(), key) >= 3){
+            game.result = GAME_DRAW;
+            game.termination = "threefold repetition";
+            break;
+        }
+        if(quiet_plies >= FIFTY_MOVE_PLIES){
+            game.result = GAME_DRAW;
+            game.termination = "fifty-move rule";
+            break;
+        }
+        if(insufficient_material(frame)){
+            game.result = GAME_DRAW;
+            game.termination = "insufficient material";
+            break;
+        }
+        if(ply >= rules.max_plies){
+            game.result = GAME_DRAW;
+            game.termination = "adjudicated: move limit";
+            break;
+        }
+
+        auto& engine {state.player_to_move? white : black};
+        searcher search{state.player_to_move? white_table : black_table, arena, engine.weights};
+        auto result {search.search(frame, state, engine.limits)};
+        game.nodes += result.nodes;
+        if(!result.found){
+            game.result = GAME_DRAW;
+            game.termination = "no search result";
+            break;
+        }
+
+        game.moves.push_back(san_move(frame, state, result.move, moves, count));
+        game.scores.push_back(result.score);
+        game.positions.push_back(frame);
+        game.states.push_back(state);
+        auto white_score {state.player_to_move? result.score : -result.score};
+        auto irreversible {result.move.capture || result.move.piece_offset == PAWN_OFFSET};
+        make_move(frame, state, result.move);
+        quiet_plies = irreversible? 0 : quiet_plies+1;
+        if(irreversible){
+            history.clear();
+        }
+
+        if(std::abs(white_score) >= rules.resign_score){
+            auto side {white_score > 0? 1 : -1};
+            resign_count = side == resign_side? resign_count+1 : 1;
+            resign_side = side;
+        }
+        else{
+            resign_count = 0;
+        }
+        if(resign_count >= rules.resign_plies){
+            game.result = resign_side > 0? GAME_WHITE_WIN : GAME_BLACK_WIN;
+            game.termination = "adjudicated: score";
+            break;
+        }
+
+        draw_count = ply+1 >= rules.draw_after_ply && std::abs(white_score) <= rules.draw_score? draw_count+1 : 0;
+        if(draw_count >= rules.draw_plies){
+            game.result = GAME_DRAW;
+            game.termination = "adjudicated: draw score";
+            break;
+        }
+    }
+    return game;
+}
+
+const char* result_text(int result){
+    if(result == GAME_WHITE_WIN) return "1-0";
+    if(result == GAME_BLACK_WIN) return "0-1";
+    return "1/2-1/2";
+}
+
+std::string to_pgn(const game_record& game, const std::string& event, size_t round){
+    std::ostringstream pgn;
+    pgn<<"[Event \""<<event<<"\"]\n";
+    pgn<<"[Site \"?\"]\n";
+    pgn<<"[Date \"????.??.??\"]\n";
+    pgn<<"[Round \""<<round<<"\"]\n";
+    pgn<<"[White \""<<game.white<<"\"]\n";
+    pgn<<"[Black \""<<game.black<<"\"]\n";
+    pgn<<"[Result \""<<result_text(game.result)<<"\"]\n";
+    auto standard_start {to_fen(bitboard_frame{}, position_state{})};
+    if(game.start_fen != standard_start){
+        pgn<<"[FEN \""<<game.start_fen<<"\"]\n";
+        pgn<<"[SetUp \"1\"]\n";
+    }
+    pgn<<"[Termination \""<<game.termination<<"\"]\n";
+    pgn<<"[PlyCount \""<<game.moves.size()<<"\"]\n\n";
+
+    auto white_first {game.start_fen.find(" w ") != std::string::npos};
+    std::string line;
+    auto emit = [&](const std::string& token){
+        if(line.size() + token.size() + 1 > 79){
+            pgn<<line<<"\n";
+            line.clear();
+        }
+        if(!line.empty()){
+            line += ' ';
+        }
+        line += token;
+    };
+    for(size_t i=0; i<game.moves.size(); ++i){
+        auto white_move {white_first == (i%2 == 0)};
+        auto move_number {(i + (white_first? 0 : 1))/2 + 1};
+        if(white_move){
+            emit(std::to_string(move_number) + ". " + game.moves[i]);
+        }
+        else if(i == 0){
+            emit(std::to_string(move_number) + "... " + game.moves[i]);
+        }
+        else{
+            emit(game.moves[i]);
+        }
+    }
+    emit(result_text(game.result));
+    pgn<<line<<"\n\n";
+    return pgn.str();
+}
+
+void sprt_test::add(int a_result){
+    if(a_result > 0) ++wins;
+    else if(a_result < 0) ++losses;
+    else ++draws;
+}
+
+double sprt_test::score() const{
+    auto n {games()};
+    return n? (wins + 0.5*draws) / n : 0.5;
+}
+
+double sprt_test::llr() const{
+    auto n {(double)games()};
+    if(n == 0){
+        return 0.0;
+    }
+    auto frequencies {regularized(wins, draws, losses)};
+    auto s {frequencies.score()};
+    auto variance {frequencies.variance()};
+    auto s0 {expected_score(elo0)};
+    auto s1 {expected_score(elo1)};
+    return (s1-s0) * (2*s - s0 - s1) * n / (2*variance);
+}
+
+double sprt_test::lower_bound() const{
+    return std::log(beta / (1-alpha));
+}
+
+double sprt_test::upper_bound() const{
+    return std::log((1-beta) / alpha);
+}
+
+int sprt_test::decision() const{
+    auto ratio {llr()};
+    if(ratio >= upper_bound()) return 1;
+    if(ratio <= lower_bound()) return -1;
+    return 0;
+}
+
+double sprt_test::elo() const{
+    return elo_from_score(score());
+}
+
+double sprt_test::elo_margin() const{
+    auto n {(double)games()};
+    if(n == 0){
+        return INFINITY;
+    }
+    auto frequencies {regularized(wins, draws, losses)};
+    auto s {frequencies.score()};
+    auto deviation {std::sqrt(frequencies.variance() / n)};
+    auto margin {(elo_from_score(s + 1.96*deviation) - elo_from_score(s - 1.96*deviation)) / 2};
+    return std::isfinite(margin)? margin : INFINITY;
+}
@@ -0,0 +1,319 @@
+#include "notation.h"
+
+#include <cctype>
+#include <cstring>
+#include <sstream>
+
+namespace{
+const char PIECE_LETTERS[] = "PRBNKQ";
+
+size_t piece_from_letter(char letter){
+    switch(letter){
+        case 'p': return PAWN_OFFSET;
+        case 'r': return ROOK_OFFSET;
+        case 'b': return BISHOP_OFFSET;
+        case 'n': return KNIGHT_OFFSET;
+        case 'k': return KING_OFFSET;
+        case 'q': return QUEEN_OFFSET;
+    }
+    return NO_PIECE_OFFSET;
+}
+
+char piece_letter(size_t struct_offset, bool white){
+    auto letter {PIECE_LETTERS[struct_offset]};
+    return white? letter : (char)(letter - 'A' + 'a');
+}
+
+// Which of file and row tell move apart from the other moves of the same
+// piece type onto the same square.
+struct san_rivals{
+    bool ambiguous {false};
+    bool same_file {false};
+    bool same_row {false};
+
+    void add(const frame_move& move, const frame_move& other){
+        if(other.piece_offset != move.piece_offset || other.to_position != move.to_position || other.from_position == move.from_position){
+            return;
+        }
+        ambiguous = true;
+        same_file |= other.from_position%BOARDSIZE == move.from_position%BOARDSIZE;
+        same_row |= other.from_position/BOARDSIZE == move.from_position/BOARDSIZE;
+    }
+};
+
+std::string san_text(const frame_move& move, const san_rivals& rivals){
+    if(move.piece_offset == KING_OFFSET && (move.from_position == move.to_position+2 || move.to_position == move.from_position+2)){
+        return move.to_position > move.from_position? "O-O" : "O-O-O";
+    }
+
+    std::string san;
+    if(move.piece_offset == PAWN_OFFSET){
+        if(move.capture){
+            san += (char)('a' + move.from_position%BOARDSIZE);
+        }
+    }
+    else{
+        san += PIECE_LETTERS[move.piece_offset];
+        if(rivals.ambiguous){
+            if(!rivals.same_file){
+                san += (char)('a' + move.from_position%BOARDSIZE);
+            }
+            else if(!rivals.same_row){
+                san += (char)('1' + move.from_position/BOARDSIZE);
+            }
+            else{
+                san += square_name(move.from_position);
+            }
+        }
+    }
+    if(move.capture){
+        san += 'x';
+    }
+    san += square_name(move.to_position);
+    if(move.promotion_offset != NO_PIECE_OFFSET){
+        san += '=';
+        san += PIECE_LETTERS[move.promotion_offset];
+    }
+    return san;
+}
+}
+
+bool parse_fen(const std::string& fen, bitboard_frame& frame, bool& player_to_move){
+    std::istringstream fields{fen};
+    std::string placement, side;
+    if(!(fields >> placement >> side)){
+        return false;
+    }
+
+    auto parsed {bitboard_frame::empty()};
+    int row{7};
+    int col{0};
+    for(auto c : placement){
+        if(c == '/'){
+            if(col != (int)BOARDSIZE){
+                return false;
+            }
+            --row;
+            col = 0;
+        }
+        else if(c >= '1' && c <= '8'){
+            col += c - '0';
+        }
+        else{
+            auto is_white {c >= 'A' && c <= 'Z'};
+            auto piece {piece_from_letter(is_white? (char)(c - 'A' + 'a') : c)};
+            if(piece == NO_PIECE_OFFSET || row < 0 || col >= (int)BOARDSIZE){
+                return false;
+            }
+            parsed.add_piece(is_white? PLAYER_OFFSET : OPPONENT_OFFSET, piece, compute_distance(row, col));
+            ++col;
+        }
+        if(col > (int)BOARDSIZE){
+            return false;
+        }
+    }
+    if(row != 0 || col != (int)BOARDSIZE || (side != "w" && side != "b")){
+        return false;
+    }
+
+    frame = parsed;
+    player_to_move = side == "w";
+    return true;
+}
+
+std::string to_fen(const bitboard_frame& frame, bool player_to_move){
+    std::string fen;
+    for(int row=BOARDSIZE-1; row>=0; --row){
+        int empty{0};
+        for(size_t col=0; col<BOARDSIZE; ++col){
+            auto position {compute_distance(row, col)};
+            auto white_piece {frame.piece_at(PLAYER_OFFSET, position)};
+            auto black_piece {frame.piece_at(OPPONENT_OFFSET, position)};
+            if(white_piece == NO_PIECE_OFFSET && black_piece == NO_PIECE_OFFSET){
+                ++empty;
+                continue;
+            }
+            if(empty){
+                fen += (char)('0' + empty);
+                empty = 0;
+            }
+            fen += white_piece != NO_PIECE_OFFSET? piece_letter(white_piece, true) : piece_letter(black_piece, false);
+        }
+        if(empty){
+            fen += (char)('0' + empty);
+        }
+        if(row){
+            fen += '/';
+        }
+    }
+    fen += player_to_move? " w - - 0 1" : " b - - 0 1";
+    return fen;
+}
+
+bool parse_fen(const std::string& fen, bitboard_frame& frame, position_state& state){
+    bitboard_frame parsed;
+    position_state parsed_state;
+    if(!parse_fen(fen, parsed, parsed_state.player_to_move)){
+        return false;
+    }
+    std::istringstream fields{fen};
+    std::string placement, side, castling{"-"}, en_passant{"-"};
+    fields >> placement >> side >> castling >> en_passant;
+
+    parsed_state.castling = 0;
+    for(auto c : castling){
+        switch(c){
+            case 'K': parsed_state.castling |= CASTLE_WHITE_KING; break;
+            case 'Q': parsed_state.castling |= CASTLE_WHITE_QUEEN; break;
+            case 'k': parsed_state.castling |= CASTLE_BLACK_KING; break;
+            case 'q': parsed_state.castling |= CASTLE_BLACK_QUEEN; break;
+            case '-': break;
+            default: return false;
+        }
+    }
+    if(en_passant != "-"){
+        if(en_passant.size() != 2 || en_passant[0] < 'a' || en_passant[0] > 'h' || en_passant[1] < '1' || en_passant[1] > '8'){
+            return false;
+        }
+        parsed_state.en_passant = compute_distance(en_passant[1]-'1', en_passant[0]-'a');
+    }
+    frame = parsed;
+    state = parsed_state;
+    return true;
+}
+
+std::string to_fen(const bitboard_frame& frame, const position_state& state){
+    auto fen {to_fen(frame, state.player_to_move)};
+    fen.resize(fen.find(' ') + 3);
+    std::string castling;
+    if(state.castling & CASTLE_WHITE_KING) castling += 'K';
+    if(state.castling & CASTLE_WHITE_QUEEN) castling += 'Q';
+    if(state.castling & CASTLE_BLACK_KING) castling += 'k';
+    if(state.castling & CASTLE_BLACK_QUEEN) castling += 'q';
+    fen += castling.empty()? "-" : castling;
+    fen += ' ';
+    fen += state.en_passant < NO_SQUARE? square_name(state.en_passant) : "-";
+    return fen + " 0 1";
+}
+
+std::string square_name(size_t position){
+    return {(char)('a' + position%BOARDSIZE), (char)('1' + position/BOARDSIZE)};
+}
+
+std::string coordinate_move(const frame_move& move){
+    auto text {square_name(move.from_position) + square_name(move.to_position)};
+    if(move.promotion_offset != NO_PIECE_OFFSET){
+        text += piece_letter(move.promotion_offset, false);
+    }
+    return text;
+}
+
+std::string san_move(const bitboard_frame& frame, const bitboard_frame& next, bool player_to_move, const bitboard_frame* successors, size_t successor_count){
+    auto side_offset {player_to_move? PLAYER_OFFSET : OPPONENT_OFFSET};
+    auto move {frame.move_between(next, side_offset)};
+    san_rivals rivals;
+    for(size_t i=0; i<successor_count; ++i){
+        rivals.add(move, frame.move_between(successors[i], side_offset));
+    }
+    return san_text(move, rivals);
+}
+
+std::string san_move(const bitboard_frame& frame, const position_state& state, const frame_move& move, const frame_move* moves, size_t count){
+    san_rivals rivals;
+    for(size_t i=0; i<count; ++i){
+        if(is_legal(frame, state, moves[i])){
+            rivals.add(move, moves[i]);
+        }
+    }
+    auto san {san_text(move, rivals)};
+
+    auto next {frame};
+    auto next_state {state};
+    make_move(next, next_state, move);
+    if(in_check(next, next_state.player_to_move? PLAYER_OFFSET : OPPONENT_OFFSET)){
+        frame_move replies[MAX_MOVES];
+        auto reply_count {generate_moves(next, next_state, replies)};
+        bool escapes{false};
+        for(size_t i=0; i<reply_count && !escapes; ++i){
+            escapes = is_legal(next, next_state, replies[i]);
+        }
+        san += escapes? '+' : '#';
+    }
+    return san;
+}
+
+bool resolve_san(const bitboard_frame& frame, const position_state& state, std::string_view san, const frame_move* moves, size_t count, frame_move& move){
+    while(!san.empty() && std::strchr("+#!?", san.back())){
+        san.remove_suffix(1);
+    }
+
+    int castle{0};   // 1 king side, -1 queen side
+    if(san == "O-O" || san == "0-0") castle = 1;
+    if(san == "O-O-O" || san == "0-0-0") castle = -1;
+
+    auto piece {PAWN_OFFSET};
+    auto promotion {NO_PIECE_OFFSET};
+    size_t to_position {NO_SQUARE};
+    int from_col{-1};
+    int from_row{-1};
+    if(!castle){
+        if(!san.empty() && san[0] >= 'A' && san[0] <= 'Z'){
+            piece = piece_from_letter((char)(san[0] - 'A' + 'a'));
+            if(piece == NO_PIECE_OFFSET || piece == PAWN_OFFSET){
+                return false;
+            }
+            san.remove_prefix(1);
+        }
+        // a square always ends in a digit, so a trailing letter is the promotion
+        if(!san.empty() && std::isalpha((unsigned char)san.back())){
+            promotion = piece_from_letter((char)std::tolower((unsigned char)san.back()));
+            san.remove_suffix(1);
+            if(!san.empty() && san.back() == '='){
+                san.remove_suffix(1);
+            }
+            if(promotion == NO_PIECE_OFFSET || promotion == PAWN_OFFSET || promotion == KING_OFFSET || piece != PAWN_OFFSET){
+                return false;
+            }
+        }
+        if(san.size() < 2){
+            return false;
+        }
+        auto col {san[san.size()-2]};
+        auto row {san[san.size()-1]};
+        if(col < 'a' || col > 'h' || row < '1' || row > '8'){
+            return false;
+        }
+        to_position = compute_distance(row-'1', col-'a');
+        san.remove_suffix(2);
+        for(auto c : san){
+            if(c >= 'a' && c <= 'h') from_col = c-'a';
+            else if(c >= '1' && c <= '8') from_row = c-'1';
+            else if(c != 'x' && c != ':' && c != '-') return false;
+        }
+    }
+
+    bool found{false};
+    for(size_t i=0; i<count; ++i){
+        auto& candidate {moves[i]};
+        if(castle){
+            auto king_step {(int)candidate.to_position - (int)candidate.from_position};
+            if(candidate.piece_offset != KING_OFFSET || king_step != 2*castle){
+                continue;
+            }
+        }
+        else if(candidate.piece_offset != piece || candidate.to_position != to_position || candidate.promotion_offset != promotion
+            || (from_col >= 0 && (int)(candidate.from_position%BOARDSIZE) != from_col)
+            || (from_row >= 0 && (int)(candidate.from_position/BOARDSIZE) != from_row)){
+            continue;
+        }
+        if(!is_legal(frame, state, candidate)){
+            continue;
+        }
+        if(found){
+            return false;
+        }
+        move = candidate;
+        found = true;
+    }
+    return found;
+}
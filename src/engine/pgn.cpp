@@ -0,0 +1,303 @@
+#include "pgn.h"
+#include "bounded_queue.h"
+#include "notation.h"
+
+#include <cctype>
+#include <cstring>
+#include <fcntl.h>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace{
+const size_t PGN_BATCH_GAMES = 64;
+const size_t PGN_BATCHES_PER_THREAD = 4;
+
+bool is_blank(char c){
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+bool is_result(std::string_view token){
+    return token == "1-0" || token == "0-1" || token == "1/2-1/2" || token == "*";
+}
+
+const char* skip_past(const char* p, const char* end, char stop){
+    if(p >= end){
+        return end;
+    }
+    auto found {static_cast<const char*>(std::memchr(p, stop, (size_t)(end-p)))};
+    return found? found+1 : end;
+}
+
+// Reads one [Name "Value"] line starting at p; returns the position after it.
+const char* read_tag(const char* p, const char* end, std::string_view& name, std::string_view& value){
+    name = std::string_view{};
+    value = std::string_view{};
+    if(p >= end){
+        return end;
+    }
+    size_t remaining {(size_t)(end-p)};
+    std::string_view line{p, remaining};
+    auto newline {line.find('\n')};
+    auto next {newline == std::string_view::npos? end : p+newline+1};
+    line = line.substr(0, newline);
+    line.remove_prefix(1);  // the '['
+
+    name = line.substr(0, line.find_first_of(" \t\r\n\"]"));
+    auto open {line.find('"', name.size())};
+    if(open != std::string_view::npos){
+        auto close {open+1};
+        while(close < line.size() && (line[close] != '"' || line[close-1] == '\\')){
+            ++close;
+        }
+        value = line.substr(open+1, close-open-1);
+    }
+    return next;
+}
+}
+
+size_t split_pgn_games(const char* data, size_t size, const std::function<void(const pgn_game_text&)>& visit){
+    size_t games{0};
+    size_t game_start{0};
+    bool in_game{false};
+    bool seen_moves{false};
+    bool in_comment{false};
+    size_t pos{0};
+    while(pos < size){
+        auto newline {static_cast<const char*>(std::memchr(data+pos, '\n', size-pos))};
+        auto line_end {newline? (size_t)(newline-data) : size};
+        auto first {pos};
+        while(first < line_end && is_blank(data[first])){
+            ++first;
+        }
+
+        if(first < line_end && data[first] == '[' && !in_comment){
+            if(seen_moves){
+                visit(pgn_game_text{data+game_start, pos-game_start, ++games});
+                in_game = false;
+                seen_moves = false;
+            }
+            if(!in_game){
+                in_game = true;
+                game_start = pos;
+            }
+        }
+        else if(first < line_end){
+            if(!in_game){
+                in_game = true;
+                game_start = pos;
+            }
+            seen_moves = true;
+            // a brace comment may run over lines that start with '['
+            for(auto i=first; i<line_end; ++i){
+                if(in_comment){
+                    in_comment = data[i] != '}';
+                }
+                else if(data[i] == '{'){
+                    in_comment = true;
+                }
+                else if(data[i] == ';'){
+                    break;
+                }
+            }
+        }
+        pos = line_end+1;
+    }
+    if(in_game){
+        visit(pgn_game_text{data+game_start, size-game_start, ++games});
+    }
+    return games;
+}
+
+pgn_game_info replay_pgn_game(const pgn_game_text& game, size_t worker, const pgn_callbacks& callbacks){
+    pgn_game_info info;
+    info.number = game.number;
+    auto p {game.text};
+    auto end {game.text + game.length};
+
+    while(p < end){
+        if(is_blank(*p)){
+            ++p;
+            continue;
+        }
+        if(*p != '['){
+            break;
+        }
+        std::string_view name, value;
+        p = read_tag(p, end, name, value);
+        if(name == "Result") info.result = value;
+        else if(name == "FEN") info.fen = value;
+    }
+
+    bitboard_frame frame;
+    position_state state;
+    if(!info.fen.empty() && !parse_fen(std::string{info.fen}, frame, state)){
+        info.failed_token = info.fen;
+        if(callbacks.on_game) callbacks.on_game(worker, info);
+        return info;
+    }
+
+    frame_move moves[MAX_MOVES];
+    int variation{0};
+    bool failed{false};
+    while(p < end && !failed){
+        auto c {*p};
+        if(is_blank(c)){
+            ++p;
+            continue;
+        }
+        switch(c){
+            case '{': p = skip_past(p, end, '}'); continue;
+            case ';': p = skip_past(p, end, '\n'); continue;
+            case '(': ++variation; ++p; continue;
+            case ')': --variation; ++p; continue;
+            case '$':
+                ++p;
+                while(p < end && std::isdigit((unsigned char)*p)) ++p;
+                continue;
+        }
+
+        auto start {p};
+        while(p < end && !is_blank(*p) && !std::strchr("{}();$", *p)){
+            ++p;
+        }
+        if(p == start){
+            ++p;
+            continue;
+        }
+        std::string_view token{start, (size_t)(p-start)};
+        if(variation > 0){
+            continue;
+        }
+        if(is_result(token)){
+            break;
+        }
+        // move numbers, possibly glued to the move: 12. 12... 12.e4
+        size_t digits{0};
+        while(digits < token.size() && std::isdigit((unsigned char)token[digits])){
+            ++digits;
+        }
+        if(digits > 0 && digits < token.size() && token[digits] == '.'){
+            while(digits < token.size() && token[digits] == '.'){
+                ++digits;
+            }
+            token.remove_prefix(digits);
+        }
+        else if(digits == token.size()){
+            continue;
+        }
+        if(token.empty()){
+            continue;
+        }
+
+        auto count {generate_moves(frame, state, moves)};
+        frame_move move;
+        if(!resolve_san(frame, state, token, moves, count, move)){
+            info.failed_token = token;
+            failed = true;
+            break;
+        }
+        if(callbacks.on_move){
+            callbacks.on_move(worker, info, pgn_ply{frame, state, move, info.plies});
+        }
+        make_move(frame, state, move);
+        ++info.plies;
+    }
+    info.complete = !failed;
+    if(callbacks.on_game){
+        callbacks.on_game(worker, info);
+    }
+    return info;
+}
+
+pgn_replay_stats replay_pgn(const char* data, size_t size, size_t threads, const pgn_callbacks& callbacks){
+    auto thread_count {threads? threads : 1};
+    bounded_queue<std::vector<pgn_game_text>> queue{PGN_BATCHES_PER_THREAD*thread_count};
+    std::vector<pgn_replay_stats> worker_stats(thread_count);
+
+    auto worker = [&](size_t index){
+        pgn_replay_stats stats;
+        std::vector<pgn_game_text> batch;
+        while(queue.pop(batch)){
+            for(auto& game : batch){
+                auto info {replay_pgn_game(game, index, callbacks)};
+                ++stats.games;
+                stats.plies += info.plies;
+                stats.failed_games += info.complete? 0 : 1;
+            }
+        }
+        worker_stats[index] = stats;
+    };
+
+    std::vector<std::thread> workers;
+    for(size_t t=0; t<thread_count; ++t){
+        workers.emplace_back(worker, t);
+    }
+    std::vector<pgn_game_text> batch;
+    batch.reserve(PGN_BATCH_GAMES);
+    split_pgn_games(data, size, [&](const pgn_game_text& game){
+        batch.push_back(game);
+        if(batch.size() == PGN_BATCH_GAMES){
+            queue.push(std::move(batch));
+            batch = std::vector<pgn_game_text>{};
+            batch.reserve(PGN_BATCH_GAMES);
+        }
+    });
+    if(!batch.empty()){
+        queue.push(std::move(batch));
+    }
+    queue.close();
+    for(auto& thread : workers){
+        thread.join();
+    }
+
+    pgn_replay_stats total;
+    for(auto& stats : worker_stats){
+        total.games += stats.games;
+        total.plies += stats.plies;
+        total.failed_games += stats.failed_games;
+    }
+    return total;
+}
+
+pgn_archive::~pgn_archive(){
+    close();
+}
+
+bool pgn_archive::open(const char* path){
+    close();
+    auto fd {::open(path, O_RDONLY)};
+    if(fd < 0){
+        return false;
+    }
+    struct stat info;
+    if(fstat(fd, &info) != 0){
+        ::close(fd);
+        return false;
+    }
+    if(info.st_size == 0){
+        ::close(fd);
+        return true;
+    }
+    auto mapped {mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0)};
+    ::close(fd);
+    if(mapped == MAP_FAILED){
+        return false;
+    }
+    // the splitter reads front to back once
+    madvise(mapped, info.st_size, MADV_SEQUENTIAL);
+    data = static_cast<const char*>(mapped);
+    size = info.st_size;
+    return true;
+}
+
+void pgn_archive::close(){
+    if(data){
+        munmap(const_cast<char*>(data), size);
+    }
+    data = nullptr;
+    size = 0;
+}
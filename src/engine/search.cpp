@@ -0,0 +1,301 @@
+#include "search.h"
+#include "engine_stats.h"
+#include "see.h"
+#include "zobrist.h"
+
+namespace{
+const uint64_t ROW_MASK = 0xFF;
+
+int32_t pawn_progress(uint64_t pawns, bool player_side){
+    int32_t rows{0};
+    for(size_t row=0; row<BOARDSIZE; ++row){
+        auto count {__builtin_popcountll(pawns & ROW_MASK<<(row*BOARDSIZE))};
+        rows += count * (int32_t)(player_side? row-1 : BOARDSIZE-2-row);
+    }
+    return rows;
+}
+
+int32_t score_to_tt(int32_t score, size_t ply){
+    if(score > MATE_BOUND) return score + (int32_t)ply;
+    if(score < -MATE_BOUND) return score - (int32_t)ply;
+    return score;
+}
+
+int32_t score_from_tt(int32_t score, size_t ply){
+    if(score > MATE_BOUND) return score - (int32_t)ply;
+    if(score < -MATE_BOUND) return score + (int32_t)ply;
+    return score;
+}
+
+// Pseudo-legal moves of the side to move, in arena memory cut to their count.
+arena_span<frame_move> arena_moves(frame_arena& arena, const bitboard_frame& frame, const position_state& state){
+    auto moves {arena.allocate<frame_move>(MAX_MOVES)};
+    auto count {generate_moves(frame, state, moves)};
+    arena.truncate(moves+count);
+    return {moves, count};
+}
+
+// Material a move wins outright: the piece it takes and what it promotes to.
+int32_t material_gain(const bitboard_frame& frame, size_t other_side, const frame_move& move, const evaluation_weights& weights){
+    int32_t gain{0};
+    if(move.capture){
+        auto victim {frame.piece_at(other_side, move.to_position)};
+        // en passant lands on an empty square
+        gain += weights.piece_values[victim == NO_PIECE_OFFSET? PAWN_OFFSET : victim];
+    }
+    if(move.promotion_offset != NO_PIECE_OFFSET){
+        gain += weights.piece_values[move.promotion_offset] - weights.piece_values[PAWN_OFFSET];
+    }
+    return gain;
+}
+
+// Selection step: brings the highest scored of the remaining entries to n.
+template<typename Item>
+void pick_best(Item* items, int32_t* scores, size_t n, size_t count){
+    auto pick {n};
+    for(size_t j=n+1; j<count; ++j){
+        if(scores[j] > scores[pick]){
+            pick = j;
+        }
+    }
+    std::swap(items[n], items[pick]);
+    std::swap(scores[n], scores[pick]);
+}
+}
+
+int32_t material(const bitboard_frame& frame, size_t side_offset, const evaluation_weights& weights){
+    int32_t total{0};
+    for(size_t piece=0; piece<PIECE_TYPES; ++piece){
+        total += __builtin_popcountll(frame.side(side_offset).pieces[piece]) * weights.piece_values[piece];
+    }
+    return total;
+}
+
+int32_t evaluate(const bitboard_frame& frame, bool player_to_move, const evaluation_weights& weights){
+    auto score {material(frame, PLAYER_OFFSET, weights) - material(frame, OPPONENT_OFFSET, weights)};
+    score += weights.pawn_advance * (pawn_progress(frame.player.pieces[PAWN_OFFSET], true) - pawn_progress(frame.opponent.pieces[PAWN_OFFSET], false));
+    return player_to_move? score : -score;
+}
+
+searcher::searcher(transposition_table& table, frame_arena& arena, const evaluation_weights& weights):
+table{table}, arena{arena}, weights{weights} {}
+
+search_result searcher::search(const bitboard_frame& frame, const position_state& state, const search_limits& limits){
+    this->limits = limits;
+    nodes = 0;
+    qnodes = 0;
+    stopped = false;
+
+    search_result result;
+    arena_scope whole_search{arena};
+    attack_map map{frame};
+    auto root_moves {arena_moves(arena, frame, state)};
+    bool any_legal{false};
+    for(auto& move : root_moves){
+        if(is_legal(frame, state, move, map)){
+            any_legal = true;
+            break;
+        }
+    }
+    if(!any_legal){
+        return result;
+    }
+
+    auto max_depth {limits.depth < MAX_SEARCH_DEPTH? limits.depth : MAX_SEARCH_DEPTH};
+    for(size_t depth=1; depth<=max_depth; ++depth){
+        arena_scope iteration{arena};
+        iteration_depth = depth;
+        root_best_index = TT_NO_MOVE;
+        auto score {negamax(frame, state, map, (int)depth, -INFINITE_SCORE, INFINITE_SCORE, 0)};
+        if(stopped || root_best_index == TT_NO_MOVE){
+            break;
+        }
+        result.found = true;
+        result.best_index = root_best_index;
+        result.score = score;
+        result.depth = depth;
+        if(score > MATE_BOUND || score < -MATE_BOUND){
+            break;
+        }
+    }
+
+    if(result.found){
+        result.move = root_moves[result.best_index];
+    }
+    result.nodes = nodes;
+    result.qnodes = qnodes;
+    return result;
+}
+
+int32_t searcher::negamax(const bitboard_frame& frame, const position_state& state, const attack_map& map, int depth, int32_t alpha, int32_t beta, size_t ply){
+    if(depth <= 0){
+        return quiesce(frame, state, map, alpha, beta, ply);
+    }
+    ++nodes;
+    STATS_INC(nodes);
+    // depth 1 always completes so there is a move to play
+    if(limits.nodes && nodes > limits.nodes && iteration_depth > 1){
+        stopped = true;
+        return 0;
+    }
+
+    auto side {state.player_to_move? PLAYER_OFFSET : OPPONENT_OFFSET};
+    auto other_side {state.player_to_move? OPPONENT_OFFSET : PLAYER_OFFSET};
+    auto key {zobrist_hash(frame, state)};
+    tt_data entry;
+    uint16_t tt_move {TT_NO_MOVE};
+    STATS_INC(tt_probes);
+    if(table.probe(key, entry)){
+        STATS_INC(tt_hits);
+        tt_move = entry.best_index;
+        if(ply > 0 && entry.depth >= depth){
+            auto score {score_from_tt(entry.score, ply)};
+            if(entry.bound == TT_BOUND_EXACT
+                || (entry.bound == TT_BOUND_LOWER && score >= beta)
+                || (entry.bound == TT_BOUND_UPPER && score <= alpha)){
+                return score;
+            }
+        }
+    }
+
+    arena_scope scope{arena};
+    auto moves {arena_moves(arena, frame, state)};
+    // hash move first, then captures and promotions by the material they win
+    auto order {arena.allocate<uint16_t>(moves.size())};
+    auto order_scores {arena.allocate<int32_t>(moves.size())};
+    for(size_t i=0; i<moves.size(); ++i){
+        order[i] = (uint16_t)i;
+        order_scores[i] = i == tt_move? INFINITE_SCORE : material_gain(frame, other_side, moves[i], weights);
+    }
+
+    auto alpha_start {alpha};
+    auto best_score {-INFINITE_SCORE};
+    uint16_t best_index {TT_NO_MOVE};
+    size_t searched{0};
+    for(size_t n=0; n<moves.size(); ++n){
+        pick_best(order, order_scores, n, moves.size());
+        auto index {order[n]};
+        if(!is_legal(frame, state, moves[index], map)){
+            continue;
+        }
+        auto move_number {searched++};
+
+        auto next {frame};
+        auto next_state {state};
+        auto next_map {map};
+        make_move(next, next_state, moves[index], next_map);
+        auto score {-negamax(next, next_state, next_map, depth-1, -beta, -alpha, ply+1)};
+        if(stopped){
+            return 0;
+        }
+        if(score > best_score){
+            best_score = score;
+            best_index = index;
+            if(ply == 0){
+                root_best_index = index;
+            }
+        }
+        if(score > alpha){
+            alpha = score;
+        }
+        if(alpha >= beta){
+            STATS_CUTOFF(move_number);
+            break;
+        }
+    }
+    if(!searched){
+        // checkmate, or stalemate
+        return map.in_check(frame, side)? -MATE_SCORE + (int32_t)ply : 0;
+    }
+
+    tt_data stored;
+    stored.score = score_to_tt(best_score, ply);
+    stored.depth = (uint8_t)depth;
+    stored.bound = best_score <= alpha_start? TT_BOUND_UPPER : best_score >= beta? TT_BOUND_LOWER : TT_BOUND_EXACT;
+    stored.best_index = best_index;
+    table.store(key, stored);
+    return best_score;
+}
+
+int32_t searcher::quiesce(const bitboard_frame& frame, const position_state& state, const attack_map& map, int32_t alpha, int32_t beta, size_t ply){
+    ++nodes;
+    ++qnodes;
+    STATS_INC(qnodes);
+    if(limits.nodes && nodes > limits.nodes && iteration_depth > 1){
+        stopped = true;
+        return 0;
+    }
+
+    auto side {state.player_to_move? PLAYER_OFFSET : OPPONENT_OFFSET};
+    auto other_side {state.player_to_move? OPPONENT_OFFSET : PLAYER_OFFSET};
+    auto checked {map.in_check(frame, side)};
+    auto best_score {-INFINITE_SCORE};
+    if(!checked || ply >= MAX_SEARCH_PLY){
+        // standing pat: the side to move is never forced to capture
+        best_score = evaluate(frame, state.player_to_move, weights);
+        if(best_score >= beta || ply >= MAX_SEARCH_PLY){
+            return best_score;
+        }
+        if(best_score > alpha){
+            alpha = best_score;
+        }
+    }
+
+    // in check every evasion is searched, otherwise captures and queen
+    // promotions that do not lose material by exchange; every capture
+    // removes a piece, so the recursion ends without a depth limit
+    arena_scope scope{arena};
+    auto moves {arena_moves(arena, frame, state)};
+    auto gains {arena.allocate<int32_t>(moves.size())};
+    size_t kept{0};
+    for(auto& move : moves){
+        auto gain {material_gain(frame, other_side, move, weights)};
+        if(!checked){
+            auto promotion {move.promotion_offset};
+            if((!move.capture && promotion == NO_PIECE_OFFSET) || (promotion != NO_PIECE_OFFSET && promotion != QUEEN_OFFSET)){
+                continue;
+            }
+            // the exchange replaces the bare value of the captured piece; an
+            // en passant landing square is empty, so that capture keeps it
+            if(move.capture && !(move.piece_offset == PAWN_OFFSET && move.to_position == state.en_passant)){
+                gain += static_exchange(frame, side, move.from_position, move.to_position, weights.piece_values)
+                    - weights.piece_values[frame.piece_at(other_side, move.to_position)];
+            }
+            if(see_pruning && gain < 0){
+                continue;
+            }
+        }
+        moves[kept] = move;
+        gains[kept++] = gain;
+    }
+
+    size_t searched{0};
+    for(size_t n=0; n<kept; ++n){
+        pick_best(moves.data, gains, n, kept);
+        if(!is_legal(frame, state, moves[n], map)){
+            continue;
+        }
+        ++searched;
+        auto next {frame};
+        auto next_state {state};
+        auto next_map {map};
+        make_move(next, next_state, moves[n], next_map);
+        auto score {-quiesce(next, next_state, next_map, -beta, -alpha, ply+1)};
+        if(stopped){
+            return 0;
+        }
+        if(score > best_score){
+            best_score = score;
+        }
+        if(score > alpha){
+            alpha = score;
+        }
+        if(alpha >= beta){
+            break;
+        }
+    }
+    if(checked && !searched){
+        return -MATE_SCORE + (int32_t)ply;
+    }
+    return best_score;
+}
@@ -0,0 +1,219 @@
+#include "training.h"
+#include "movegen.h"
+#include "zobrist.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+namespace{
+uint64_t game_seed(uint64_t seed, uint64_t game){
+    // splitmix64 finalizer, so neighbouring games get unrelated openings
+    auto z {seed + (game+1)*0x9E3779B97F4A7C15};
+    z = (z ^ (z>>30)) * 0xBF58476D1CE4E5B9;
+    z = (z ^ (z>>27)) * 0x94D049BB133111EB;
+    return z ^ (z>>31);
+}
+
+// Uniformly random legal moves of every piece type.
+bool random_opening(const training_options& options, uint64_t seed, bitboard_frame& frame, position_state& state){
+    std::mt19937_64 rng{seed};
+    frame = options.start;
+    state = options.start_state;
+    attack_map map{frame};
+    frame_move moves[MAX_MOVES];
+    for(size_t ply=0; ply<options.random_plies; ++ply){
+        auto count {generate_moves(frame, state, moves)};
+        size_t legal{0};
+        for(size_t i=0; i<count; ++i){
+            if(is_legal(frame, state, moves[i], map)){
+                moves[legal++] = moves[i];
+            }
+        }
+        if(legal == 0){
+            return false;
+        }
+        make_move(frame, state, moves[std::uniform_int_distribution<size_t>(0, legal-1)(rng)], map);
+    }
+    return true;
+}
+
+bool load_existing(const char* path, std::unordered_set<uint64_t>& seen, training_stats& stats){
+    std::error_code error;
+    if(!std::filesystem::exists(path, error)){
+        return true;
+    }
+    auto size {std::filesystem::file_size(path, error)};
+    if(error){
+        return false;
+    }
+    if(size % TRAINING_RECORD_SIZE){
+        size -= size % TRAINING_RECORD_SIZE;
+        std::filesystem::resize_file(path, size, error);
+        if(error){
+            return false;
+        }
+    }
+    std::ifstream in(path, std::ios::binary);
+    if(!in){
+        return false;
+    }
+    unsigned char buffer[TRAINING_RECORD_SIZE];
+    while(in.read((char*)buffer, TRAINING_RECORD_SIZE)){
+        seen.insert(decode_training_record(buffer).hash());
+        ++stats.resumed;
+    }
+    return true;
+}
+}
+
+uint64_t training_record::hash() const{
+    return zobrist_hash(board.to_frame(), player_to_move);
+}
+
+void encode_training_record(const training_record& record, unsigned char* out){
+    for(size_t i=0; i<COMPRESSED_BOARD_SIZE; ++i){
+        out[i] = record.board.data[i];
+    }
+    auto score {(uint16_t)record.score};
+    out[32] = record.player_to_move? 1 : 0;
+    out[33] = (unsigned char)(score & 0xFF);
+    out[34] = (unsigned char)(score >> 8);
+    out[35] = (unsigned char)record.result;
+}
+
+training_record decode_training_record(const unsigned char* in){
+    training_record record;
+    for(size_t i=0; i<COMPRESSED_BOARD_SIZE; ++i){
+        record.board.data[i] = in[i];
+    }
+    record.player_to_move = in[32] != 0;
+    record.score = (int16_t)(uint16_t)(in[33] | in[34]<<8);
+    record.result = (int8_t)in[35];
+    return record;
+}
+
+bool is_quiet_position(const bitboard_frame& frame, const position_state& state){
+    attack_map map{frame};
+    // the side not to move in check cannot come from a legal move, and its
+    // king would be the first capture
+    if(map.in_check(frame, PLAYER_OFFSET) || map.in_check(frame, OPPONENT_OFFSET)){
+        return false;
+    }
+    frame_move moves[MAX_MOVES];
+    auto count {generate_moves(frame, state, moves)};
+    for(size_t i=0; i<count; ++i){
+        if(moves[i].capture && is_legal(frame, state, moves[i], map)){
+            return false;
+        }
+    }
+    return true;
+}
+
+bool play_training_game(const training_options& options, uint64_t game, game_record& record){
+    bitboard_frame start;
+    position_state state;
+    if(!random_opening(options, game_seed(options.seed, game), start, state)){
+        return false;
+    }
+    engine_config engine;
+    engine.name = "training";
+    engine.limits.nodes = options.nodes;
+    engine.weights = options.weights;
+    engine.hash_mb = options.hash_mb;
+    record = play_game(start, state, engine, engine, options.rules);
+    return true;
+}
+
+bool generate_training_data(const char* path, const training_options& options, training_stats& stats,
+    const std::function<void(const training_stats&)>& on_game){
+    stats = training_stats{};
+    std::unordered_set<uint64_t> seen;
+    if(!load_existing(path, seen, stats)){
+        return false;
+    }
+    if(stats.resumed >= options.positions){
+        return true;
+    }
+    std::ofstream out(path, std::ios::binary | std::ios::app);
+    if(!out){
+        return false;
+    }
+
+    auto thread_count {options.threads? options.threads : 1};
+    std::atomic<uint64_t> next_game{0};
+    std::atomic<bool> done{false};
+    std::mutex output_lock;
+    auto total {stats.resumed};
+
+    auto worker = [&](){
+        std::vector<training_record> records;
+        while(!done){
+            // resumed runs continue the seed stream instead of replaying it
+            game_record game;
+            if(!play_training_game(options, stats.resumed + next_game++, game)){
+                continue;
+            }
+
+            records.clear();
+            uint64_t noisy{0};
+            for(size_t ply=0; ply<game.positions.size(); ++ply){
+                auto& state {game.states[ply]};
+                auto score {game.scores[ply]};
+                if(std::abs(score) > options.max_score || !is_quiet_position(game.positions[ply], state)){
+                    ++noisy;
+                    continue;
+                }
+                training_record record;
+                record.board = compressed_board{game.positions[ply]};
+                record.player_to_move = state.player_to_move;
+                record.score = (int16_t)(state.player_to_move? score : -score);
+                record.result = (int8_t)game.result;
+                records.push_back(record);
+            }
+
+            std::lock_guard<std::mutex> guard{output_lock};
+            if(done){
+                return;
+            }
+            unsigned char buffer[TRAINING_RECORD_SIZE];
+            for(auto& record : records){
+                if(total >= options.positions){
+                    break;
+                }
+                if(!seen.insert(record.hash()).second){
+                    ++stats.duplicates;
+                    continue;
+                }
+                encode_training_record(record, buffer);
+                out.write((const char*)buffer, TRAINING_RECORD_SIZE);
+                ++stats.written;
+                ++total;
+            }
+            out.flush();
+            ++stats.games;
+            stats.noisy += noisy;
+            if(on_game){
+                on_game(stats);
+            }
+            if(total >= options.positions || !out){
+                done = true;
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for(size_t t=0; t<thread_count; ++t){
+        threads.emplace_back(worker);
+    }
+    for(auto& thread : threads){
+        thread.join();
+    }
+    return (bool)out;
+}
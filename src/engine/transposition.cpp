@@ -0,0 +1,60 @@
+#include "transposition.h"
+
+namespace{
+// valid slots always carry a non-zero data word; bounds only use bits 40-41
+const uint64_t OCCUPIED = (uint64_t)1<<47;
+const uint64_t BOUND_BITS = 0x3;
+
+uint64_t pack(const tt_data& entry){
+    return (uint64_t)(uint32_t)entry.score
+        | (uint64_t)entry.depth<<32
+        | (uint64_t)entry.bound<<40
+        | (uint64_t)entry.best_index<<48;
+}
+
+tt_data unpack(uint64_t packed){
+    tt_data entry;
+    entry.score = (int32_t)(uint32_t)packed;
+    entry.depth = (uint8_t)(packed>>32);
+    entry.bound = (uint8_t)(packed>>40 & BOUND_BITS);
+    entry.best_index = (uint16_t)(packed>>48);
+    return entry;
+}
+}
+
+transposition_table::transposition_table(size_t megabytes){
+    size_t count{1};
+    while(count*2*sizeof(slot) <= megabytes*1024*1024){
+        count *= 2;
+    }
+    slots = std::make_unique<slot[]>(count);
+    mask = count-1;
+}
+
+bool transposition_table::probe(uint64_t key, tt_data& found) const{
+    auto& entry {slots[key & mask]};
+    auto data {entry.data.load(std::memory_order_relaxed)};
+    if(!data || (entry.check.load(std::memory_order_relaxed) ^ data) != key){
+        return false;
+    }
+    found = unpack(data);
+    return true;
+}
+
+void transposition_table::store(uint64_t key, const tt_data& entry){
+    auto& target {slots[key & mask]};
+    auto old_data {target.data.load(std::memory_order_relaxed)};
+    if(old_data && (target.check.load(std::memory_order_relaxed) ^ old_data) == key && unpack(old_data).depth > entry.depth){
+        return;
+    }
+    auto data {pack(entry) | OCCUPIED};
+    target.check.store(key ^ data, std::memory_order_relaxed);
+    target.data.store(data, std::memory_order_relaxed);
+}
+
+void transposition_table::clear(){
+    for(size_t i=0; i<=mask; ++i){
+        slots[i].check.store(0, std::memory_order_relaxed);
+        slots[i].data.store(0, std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include<cstdint>
+#include<cstddef>
+#include<iosfwd>
+#include<string>
+
+#include "bitboard.h"
+#include "movegen.h"
+#include "search.h"
+
+struct analysis_job{
+    size_t index {0};       // input line number, from 1
+    std::string id;         // EPD id operation, if any
+    std::string fen;
+    bitboard_frame frame;
+    position_state state;
+    bool valid {false};
+};
+
+// Reads one FEN or EPD line. Blank lines and # comments give false; other
+// unparsable lines give a job with valid unset, reported as an error.
+bool parse_analysis_line(const std::string& line, size_t index, analysis_job& job);
+
+// One JSON object on one line: index, id, fen, bestmove (UCI), san, score
+// (centipawns for the side to move), mate (moves, sign as score) when the
+// score is a mate, depth, nodes, time_ms.
+std::string analysis_json(const analysis_job& job, const search_result& result, double milliseconds);
+std::string analysis_error_json(const analysis_job& job, const char* error);
+
+struct analysis_options{
+    size_t threads {1};
+    size_t hash_mb {64};
+    size_t queue_capacity {0};      // 0 means four jobs per thread
+    search_limits limits {6, 0};
+    evaluation_weights weights;
+};
+
+// Analyzes every position of in on a worker pool sharing one transposition
+// table. Results are written to out as each finishes, so lines come in
+// completion order; index ties them back to the input. Input is read
+// through a bounded queue, memory does not grow with the input.
+// Returns the number of lines written.
+size_t analyze_stream(std::istream& in, std::ostream& out, const analysis_options& options);
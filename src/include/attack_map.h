@@ -0,0 +1,31 @@
+#pragma once
+
+#include<cstdint>
+#include<cstddef>
+
+#include "bitboard.h"
+
+// Which squares each side attacks, kept next to a frame the way
+// position_state is, so the frame stays two cache lines. Pawns attack
+// diagonally whether or not the square is occupied, sliders stop on the
+// first occupied square and include it.
+struct attack_map{
+    uint64_t from_square[BOARDSIZE*BOARDSIZE];     // attacks of the piece on each square, 0 when empty
+    uint64_t attacked[SIDES];
+    uint64_t slider_attacked[SIDES];                // by rooks, bishops and queens only
+    uint8_t counts[SIDES][BOARDSIZE*BOARDSIZE];    // attackers per square
+
+    attack_map() = default;
+    explicit attack_map(const bitboard_frame& frame);
+
+    void build(const bitboard_frame& frame);
+    // Brings the map from before to after, which may differ by any move
+    // including castling, en passant and promotion. Only the pieces on changed
+    // squares and the sliders whose rays reached one are recomputed.
+    void update(const bitboard_frame& before, const bitboard_frame& after);
+
+    bool is_attacked(size_t by_side_offset, size_t square) const { return (attacked[by_side_offset]>>square)&1; }
+    bool in_check(const bitboard_frame& frame, size_t side_offset) const {
+        return (frame.side(side_offset).pieces[KING_OFFSET] & attacked[side_offset == PLAYER_OFFSET? OPPONENT_OFFSET : PLAYER_OFFSET]) != 0;
+    }
+};
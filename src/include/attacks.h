@@ -0,0 +1,20 @@
+#pragma once
+
+#include<cstdint>
+#include<cstddef>
+
+#include "bitboard.h"
+
+// Squares attacked by every pawn on the board of side_offset.
+uint64_t pawn_attacks(size_t side_offset, uint64_t pawns);
+uint64_t knight_attacks(uint64_t knights);
+uint64_t king_attacks(uint64_t kings);
+// Sliding attacks from one square, each ray ending on the first occupied square.
+uint64_t rook_attacks(size_t square, uint64_t occupied);
+uint64_t bishop_attacks(size_t square, uint64_t occupied);
+// Attacks of the side_offset piece on square, 0 when the square has none.
+uint64_t attacks_from(const bitboard_frame& frame, size_t side_offset, size_t square);
+
+// Pieces of both sides attacking square, with sliders blocked by occupied.
+// Passing a thinned occupied exposes the pieces behind removed ones.
+uint64_t attackers_to(const bitboard_frame& frame, size_t square, uint64_t occupied);
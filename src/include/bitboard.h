@@ -1,7 +1,11 @@
+#pragma once
+
 #include<cstdint>
 #include<cstddef>
 #include<vector>
 
+#include "frame_arena.h"
+
 const size_t BOARDSIZE = 8;
 const uint64_t MASK_OFF_LEFT = 0x7F7F7F7F7F7F7F7F;
 const uint64_t MASK_OFF_RIGHT = 0xFEFEFEFEFEFEFEFE;
@@ -72,29 +76,19 @@ const size_t BISHOP_OFFSET = 2;
 const size_t KNIGHT_OFFSET = 3;
 const size_t KING_OFFSET = 4;
 const size_t QUEEN_OFFSET = 5;
+const size_t NO_PIECE_OFFSET = 6;
 
 struct bitboard_move{
     int distance;
     uint64_t board;
 };
 
-struct bitboard_player_set{
-    uint64_t pawns;
-    uint64_t rooks;
-    uint64_t bishops;
-    uint64_t knights;
-    uint64_t king;
-    uint64_t queen;
-#ifdef UNITTEST
-    uint64_t barrier;
-#endif
-
-    bitboard_player_set(bool opponent=false);
-    uint64_t full_player_board();
-
-    void remove_piece(size_t struct_offset, size_t absolute_position);
-    void remove_pieces(size_t absolute_position);
-    void move_piece(size_t struct_offset, size_t from_position, size_t to_position);
+struct frame_move{
+    size_t from_position;
+    size_t to_position;
+    size_t piece_offset;
+    size_t promotion_offset;
+    bool capture;
 };
 
 struct ascii_array{
@@ -104,14 +98,59 @@ struct ascii_array{
 const size_t PLAYER_OFFSET = 0;
 const size_t OPPONENT_OFFSET = 1;
 
-struct bitboard_frame{
-    bitboard_player_set player;
-    bitboard_player_set opponent;
-    bitboard_frame(bitboard_player_set player, bitboard_player_set opponent);
-    ascii_array to_ascii_array();
+const size_t PIECE_TYPES = 6;
+const size_t SIDES = 2;
+
+// The per-side half of a frame: piece boards indexed by *_OFFSET, then the
+// side's occupancy.
+struct side_boards{
+    uint64_t pieces[PIECE_TYPES];
+    uint64_t occupancy;
+};
+
+// Two 64-byte cache lines, one per side. The player's line ends with the
+// all-pieces word and the opponent's with padding, so a side's boards never
+// straddle a line. The mutators below keep the occupancy words in step, so
+// the layout is the same in every build and occupancy is a single load.
+struct alignas(64) bitboard_frame{
+    side_boards player;
+    uint64_t occupied;
+    alignas(64) side_boards opponent;
+
+    // Standard starting position.
+    bitboard_frame();
+    static bitboard_frame empty();
+
+    side_boards& side(size_t side_offset) { return side_offset == PLAYER_OFFSET? player : opponent; }
+    const side_boards& side(size_t side_offset) const { return side_offset == PLAYER_OFFSET? player : opponent; }
+    uint64_t full_player_board(size_t side_offset) const { return side(side_offset).occupancy; }
+    size_t piece_at(size_t side_offset, size_t absolute_position) const;
+
+    void set_pieces(size_t side_offset, size_t struct_offset, uint64_t board);
+    void add_piece(size_t side_offset, size_t struct_offset, size_t absolute_position);
+    void remove_piece(size_t side_offset, size_t struct_offset, size_t absolute_position);
+    void remove_pieces(size_t side_offset, size_t absolute_position);
+    void move_piece(size_t side_offset, size_t struct_offset, size_t from_position, size_t to_position);
+    void clear();
+
+    ascii_array to_ascii_array() const;
     std::vector<bitboard_frame> get_next_boards();
     std::vector<bitboard_frame> get_opponent_next_boards();
-    bitboard_frame clone_from_player_move(size_t struct_offset, size_t from_position, size_t to_position);
-    bitboard_frame clone_from_opponent_move(size_t struct_offset, size_t from_position, size_t to_position);
-    bitboard_frame remove_pieces(size_t struct_offset, size_t position);
-};
\ No newline at end of file
+    // Same successors, written into arena memory instead of a fresh vector.
+    arena_span<bitboard_frame> get_next_boards(frame_arena& arena);
+    arena_span<bitboard_frame> get_opponent_next_boards(frame_arena& arena);
+    // Captures side_offset can make, listed as moves so they can be screened
+    // before a successor is built. Covers the pieces the generators move;
+    // moves needs room for MAX_NEXT_BOARDS entries.
+    size_t get_captures(size_t side_offset, frame_move* moves) const;
+    bitboard_frame clone_from_player_move(size_t struct_offset, size_t from_position, size_t to_position) const;
+    bitboard_frame clone_from_opponent_move(size_t struct_offset, size_t from_position, size_t to_position) const;
+    // Recovers the move side_offset made to get from this frame to next.
+    frame_move move_between(const bitboard_frame& next, size_t side_offset) const;
+    bitboard_frame clone_from_played_move(size_t side_offset, size_t from_position, size_t to_position, size_t promotion_offset=NO_PIECE_OFFSET) const;
+};
+
+static_assert(sizeof(bitboard_frame) == 128, "frame must stay two cache lines");
+static_assert(offsetof(bitboard_frame, player) == 0, "the player's boards fill the first line");
+static_assert(offsetof(bitboard_frame, occupied) == sizeof(side_boards), "the all-pieces word completes the player's line");
+static_assert(offsetof(bitboard_frame, opponent) == 64, "the opponent's boards fill the second line");
@@ -0,0 +1,65 @@
+#pragma once
+
+#include<cstdint>
+#include<cstddef>
+#include<istream>
+#include<map>
+#include<random>
+#include<string>
+#include<utility>
+
+#include "bitboard.h"
+#include "movegen.h"
+
+// Polyglot book entries are 16 bytes, big-endian, sorted by key.
+const size_t BOOK_ENTRY_SIZE = 16;
+
+struct book_move{
+    size_t from_position;
+    size_t to_position;
+    size_t promotion_offset;
+    uint16_t weight;
+};
+
+// Polyglot encodes castling as the king taking its own rook; decoding maps it
+// back to the two-file king move that clone_from_played_move expects.
+uint16_t encode_book_move(size_t from_position, size_t to_position, size_t promotion_offset, bool castling=false);
+book_move decode_book_move(uint16_t move, const bitboard_frame& frame, size_t side_offset);
+
+struct opening_book{
+    const unsigned char* entries {nullptr};
+    size_t entry_count {0};
+    size_t mapped_size {0};
+
+    opening_book() = default;
+    opening_book(const opening_book&) = delete;
+    opening_book& operator=(const opening_book&) = delete;
+    ~opening_book();
+
+    bool open(const char* path);
+    void close();
+    bool is_open() const;
+
+    uint64_t key_at(size_t index) const;
+
+    // Writes up to capacity raw Polyglot moves for key, returns how many exist.
+    size_t probe(uint64_t key, uint16_t* moves, uint16_t* weights, size_t capacity) const;
+
+    // Weighted random choice among the book moves for the side to move. Keys
+    // are full Polyglot keys, so castling rights and en passant count.
+    bool pick(const bitboard_frame& frame, const position_state& state, std::mt19937_64& rng, book_move& chosen) const;
+};
+
+struct book_builder{
+    std::map<std::pair<uint64_t, uint16_t>, uint32_t> counts;
+    size_t max_ply;
+
+    book_builder(size_t max_ply=20);
+
+    // One game of coordinate moves ("e2e4 e7e5 g1f3 ..."), starting from the
+    // initial position. Stops at the first token that is not a move.
+    size_t add_game(const std::string& line);
+    size_t add_games(std::istream& in);
+
+    bool write(const char* path) const;
+};
@@ -0,0 +1,53 @@
+#pragma once
+
+#include<condition_variable>
+#include<cstddef>
+#include<deque>
+#include<mutex>
+
+// Blocking multi-producer, multi-consumer queue holding at most capacity
+// items, so a fast producer waits for its consumers instead of buffering.
+template<typename T>
+struct bounded_queue{
+    std::mutex lock;
+    std::condition_variable not_full;
+    std::condition_variable not_empty;
+    std::deque<T> items;
+    size_t capacity;
+    bool closed {false};
+
+    bounded_queue(size_t capacity): capacity{capacity? capacity : 1} {}
+
+    // Returns false once the queue is closed.
+    bool push(T item){
+        std::unique_lock<std::mutex> guard{lock};
+        not_full.wait(guard, [&](){ return closed || items.size() < capacity; });
+        if(closed){
+            return false;
+        }
+        items.push_back(std::move(item));
+        not_empty.notify_one();
+        return true;
+    }
+
+    // Waits for an item; returns false when the queue is closed and drained.
+    bool pop(T& item){
+        std::unique_lock<std::mutex> guard{lock};
+        not_empty.wait(guard, [&](){ return closed || !items.empty(); });
+        if(items.empty()){
+            return false;
+        }
+        item = std::move(items.front());
+        items.pop_front();
+        not_full.notify_one();
+        return true;
+    }
+
+    // No more pushes; consumers finish what is queued.
+    void close(){
+        std::lock_guard<std::mutex> guard{lock};
+        closed = true;
+        not_full.notify_all();
+        not_empty.notify_all();
+    }
+};
@@ -0,0 +1,25 @@
+#pragma once
+
+#include<cstdint>
+#include<cstddef>
+
+#include "bitboard.h"
+
+const size_t COMPRESSED_BOARD_SIZE = 32;
+
+// One nibble per square, square 0 in the low nibble of data[0]. 0 is an empty
+// square, piece_offset+1 a player piece and piece_offset+9 an opponent piece.
+// Side to move, castling and en passant are not kept.
+struct compressed_board{
+    uint8_t data[COMPRESSED_BOARD_SIZE] {};
+
+    compressed_board() = default;
+    explicit compressed_board(const bitboard_frame& frame);
+
+    uint8_t square(size_t position) const;
+    bitboard_frame to_frame() const;
+
+    bool operator==(const compressed_board& other) const;
+};
+
+static_assert(sizeof(compressed_board) == COMPRESSED_BOARD_SIZE);
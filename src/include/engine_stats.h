@@ -0,0 +1,100 @@
+#pragma once
+
+#include<atomic>
+#include<chrono>
+#include<cstdint>
+#include<cstddef>
+
+// Hot-path instrumentation. The STATS_* macros below only expand to code when
+// the engine is built with ENGINE_STATS (CMake option of the same name); the
+// aggregation API is always present and reports zeros otherwise.
+
+const size_t STATS_CUTOFF_SLOTS = 8;     // last slot collects every later move index
+const size_t STATS_PIECE_SLOTS = 6;      // indexed by *_OFFSET
+const size_t STATS_EMIT_SLOT = STATS_PIECE_SLOTS;
+
+// Single-writer counter: the owning thread increments with a plain load and
+// store, other threads may read it at any time. No lock-prefixed RMW.
+struct stat_counter{
+    std::atomic<uint64_t> value {0};
+
+    void add(uint64_t amount){
+        value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+    uint64_t get() const{
+        return value.load(std::memory_order_relaxed);
+    }
+};
+
+struct engine_stats_snapshot{
+    uint64_t nodes {0};
+    uint64_t qnodes {0};
+    uint64_t tt_probes {0};
+    uint64_t tt_hits {0};
+    uint64_t cutoffs[STATS_CUTOFF_SLOTS] {};
+    uint64_t generation_calls {0};
+    uint64_t generated_boards {0};
+    // mask stage per piece type, then successor emission in STATS_EMIT_SLOT
+    uint64_t generation_ns[STATS_PIECE_SLOTS+1] {};
+
+    double branching_factor() const;
+    double tt_hit_rate() const;
+    // share of cutoffs produced by the first move searched
+    double first_move_cutoff_rate() const;
+};
+
+struct engine_stats{
+    stat_counter nodes;
+    stat_counter qnodes;
+    stat_counter tt_probes;
+    stat_counter tt_hits;
+    stat_counter cutoffs[STATS_CUTOFF_SLOTS];
+    stat_counter generation_calls;
+    stat_counter generated_boards;
+    stat_counter generation_ns[STATS_PIECE_SLOTS+1];
+
+    engine_stats();
+    ~engine_stats();
+    engine_stats(const engine_stats&) = delete;
+    engine_stats& operator=(const engine_stats&) = delete;
+
+    void add_to(engine_stats_snapshot& total) const;
+};
+
+// Counters of the calling thread, registered for aggregation on first use.
+engine_stats& thread_engine_stats();
+
+// Sums every live thread's counters plus those of threads that have exited.
+engine_stats_snapshot aggregate_engine_stats();
+// Meant for quiet points between searches; a thread counting concurrently
+// may write back a value read before the reset.
+void reset_engine_stats();
+
+constexpr bool engine_stats_enabled(){
+#ifdef ENGINE_STATS
+    return true;
+#else
+    return false;
+#endif
+}
+
+// Adds the time since clock to a generation slot and restarts the clock.
+inline void stats_lap(std::chrono::steady_clock::time_point& clock, size_t slot){
+    auto now {std::chrono::steady_clock::now()};
+    thread_engine_stats().generation_ns[slot].add(std::chrono::duration_cast<std::chrono::nanoseconds>(now - clock).count());
+    clock = now;
+}
+
+#ifdef ENGINE_STATS
+#define STATS_ADD(field, amount) (thread_engine_stats().field.add(amount))
+#define STATS_INC(field) STATS_ADD(field, 1)
+#define STATS_CUTOFF(move_index) STATS_INC(cutoffs[(size_t)(move_index) < STATS_CUTOFF_SLOTS? (size_t)(move_index) : STATS_CUTOFF_SLOTS-1])
+#define STATS_CLOCK(clock) auto clock {std::chrono::steady_clock::now()}
+#define STATS_LAP(clock, slot) stats_lap(clock, slot)
+#else
+#define STATS_ADD(field, amount) ((void)0)
+#define STATS_INC(field) ((void)0)
+#define STATS_CUTOFF(move_index) ((void)0)
+#define STATS_CLOCK(clock) ((void)0)
+#define STATS_LAP(clock, slot) ((void)0)
+#endif
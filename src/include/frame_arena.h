@@ -0,0 +1,112 @@
+#pragma once
+
+#include<cstdint>
+#include<cstddef>
+#include<cstring>
+#include<new>
+#include<type_traits>
+#include<utility>
+
+// Upper bound on successors from a single position, used to size arena runs.
+const size_t MAX_NEXT_BOARDS = 256;
+const size_t DEFAULT_ARENA_BYTES = 8*1024*1024;
+
+// Bump allocator: one heap block up front, pointer-bump allocation, and
+// rewinding by mark instead of per-object frees. Only trivially destructible
+// types may live in it since nothing is ever destroyed.
+struct frame_arena{
+    unsigned char* data;
+    size_t capacity;
+    size_t used {0};
+    size_t peak {0};
+
+    frame_arena(size_t capacity=DEFAULT_ARENA_BYTES);
+    frame_arena(const frame_arena&) = delete;
+    frame_arena& operator=(const frame_arena&) = delete;
+    ~frame_arena();
+
+    // Throws std::bad_alloc when the block is exhausted.
+    void* allocate(size_t bytes, size_t alignment);
+
+    template<typename T>
+    T* allocate(size_t count){
+        static_assert(std::is_trivially_destructible_v<T>, "arena memory is never destroyed");
+        return static_cast<T*>(allocate(sizeof(T)*count, alignof(T)));
+    }
+
+    size_t mark() const { return used; }
+    void release_to(size_t mark) { used = mark; }
+    // Gives back the unused tail of the most recent allocation.
+    void truncate(const void* end) { used = static_cast<const unsigned char*>(end) - data; }
+    void reset() { used = 0; }
+
+    size_t peak_usage() const { return peak; }
+    void reset_peak() { peak = used; }
+};
+
+// Arena for the calling thread, created on first use.
+frame_arena& thread_frame_arena();
+
+// Rewinds an arena to where it was on construction, e.g. once per search node.
+struct arena_scope{
+    frame_arena& arena;
+    size_t saved;
+    arena_scope(frame_arena& arena): arena{arena}, saved{arena.mark()} {}
+    ~arena_scope(){ arena.release_to(saved); }
+};
+
+template<typename T>
+struct arena_span{
+    T* data;
+    size_t count;
+
+    T* begin() const { return data; }
+    T* end() const { return data+count; }
+    size_t size() const { return count; }
+    T& operator[](size_t i) const { return data[i]; }
+};
+
+// List carved out of an arena. Filling it past its capacity grows the run:
+// in place when nothing was allocated after it, otherwise by copying into a
+// run twice the size, the old one staying until the arena rewinds. finish()
+// hands the unused capacity back so the next allocation starts right after
+// the last element.
+template<typename T>
+struct arena_list{
+    static_assert(std::is_trivially_copyable_v<T>, "arena_list relocates by copying bytes");
+
+    frame_arena& arena;
+    T* data;
+    size_t capacity;
+    size_t count {0};
+
+    arena_list(frame_arena& arena, size_t capacity): arena{arena}, data{arena.allocate<T>(capacity)}, capacity{capacity} {}
+
+    template<typename... Args>
+    T& emplace_back(Args&&... args){
+        if(count == capacity){
+            grow();
+        }
+        return *new(data+count++) T(std::forward<Args>(args)...);
+    }
+    T& back(){ return data[count-1]; }
+    size_t size() const { return count; }
+
+    arena_span<T> finish(){
+        arena.truncate(data+count);
+        return {data, count};
+    }
+
+    void grow(){
+        auto extra {capacity? capacity : 1};
+        if(reinterpret_cast<unsigned char*>(data+capacity) == arena.data+arena.mark()){
+            arena.allocate<T>(extra);
+            capacity += extra;
+            return;
+        }
+        auto moved {arena.allocate<T>(capacity+extra)};
+        std::memcpy(static_cast<void*>(moved), data, sizeof(T)*count);
+        data = moved;
+        capacity += extra;
+    }
+};
@@ -0,0 +1,38 @@
+#pragma once
+
+#include<cstdint>
+#include<cstddef>
+#include<vector>
+
+#include "bitboard.h"
+
+// Positions handled together by the vectorised mask stages.
+const size_t BATCH_LANES = 4;
+
+// Structure-of-arrays view of many frames: one array per side and piece
+// bitboard, indexed [PLAYER_OFFSET/OPPONENT_OFFSET][*_OFFSET][position].
+struct frame_batch{
+    std::vector<uint64_t> boards[SIDES][PIECE_TYPES];
+
+    size_t size() const { return boards[PLAYER_OFFSET][PAWN_OFFSET].size(); }
+    void clear();
+    void push_back(const bitboard_frame& frame);
+    bitboard_frame frame_at(size_t index) const;
+};
+
+// Successors of every input back to back; input i owns
+// boards[offsets[i], offsets[i+1]). Reusing one output keeps its capacity.
+struct successor_batch{
+    std::vector<bitboard_frame> boards;
+    std::vector<size_t> offsets;
+
+    size_t count(size_t index) const { return offsets[index+1] - offsets[index]; }
+    const bitboard_frame* begin(size_t index) const { return boards.data() + offsets[index]; }
+    const bitboard_frame* end(size_t index) const { return boards.data() + offsets[index+1]; }
+};
+
+// Same successor sets as get_next_boards()/get_opponent_next_boards() for
+// every frame in the batch, in piece-then-square order rather than the
+// scalar interleaving. Pawn pushes, pawn strikes and rook rays run across
+// BATCH_LANES positions per instruction.
+void get_next_boards_batch(const frame_batch& batch, bool player_to_move, successor_batch& out);
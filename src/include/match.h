@@ -0,0 +1,78 @@
+#pragma once
+
+#include<cstdint>
+#include<cstddef>
+#include<string>
+#include<vector>
+
+#include "bitboard.h"
+#include "movegen.h"
+#include "search.h"
+
+struct engine_config{
+    std::string name {"engine"};
+    search_limits limits;
+    evaluation_weights weights;
+    size_t hash_mb {16};
+};
+
+// Parses "key=value,key=value" overrides: name, depth, nodes, hash, pawn,
+// rook, bishop, knight, queen, advance. Returns false on an unknown key.
+bool parse_engine_config(const std::string& spec, engine_config& config);
+
+struct adjudication_rules{
+    size_t max_plies {300};         // drawn once reached
+    int32_t resign_score {800};     // both engines agree on a score this large ...
+    size_t resign_plies {8};        // ... for this many consecutive plies
+    int32_t draw_score {10};        // both engines near zero ...
+    size_t draw_plies {20};         // ... for this many consecutive plies ...
+    size_t draw_after_ply {80};     // ... past this ply
+};
+
+const int GAME_WHITE_WIN = 1;
+const int GAME_DRAW = 0;
+const int GAME_BLACK_WIN = -1;
+
+struct game_record{
+    std::string start_fen;
+    std::string white;
+    std::string black;
+    std::vector<std::string> moves;     // SAN
+    std::vector<int32_t> scores;        // mover's search score for each move
+    std::vector<bitboard_frame> positions;  // position before each move
+    std::vector<position_state> states;     // and its side to move, castling and en passant
+    int result {GAME_DRAW};
+    std::string termination;
+    uint64_t nodes {0};
+};
+
+// Plays one game of chess; each engine gets its own transposition table. It
+// ends on checkmate, stalemate, threefold repetition, the fifty-move rule,
+// bare kings (or one minor piece), or by adjudication.
+game_record play_game(const bitboard_frame& start, const position_state& state, const engine_config& white, const engine_config& black, const adjudication_rules& rules);
+
+const char* result_text(int result);
+std::string to_pgn(const game_record& game, const std::string& event, size_t round);
+
+// Trinomial GSPRT on the score of engine A against engine B.
+struct sprt_test{
+    double elo0 {0.0};
+    double elo1 {5.0};
+    double alpha {0.05};
+    double beta {0.05};
+    size_t wins {0};
+    size_t draws {0};
+    size_t losses {0};
+
+    void add(int a_result);
+    size_t games() const { return wins + draws + losses; }
+    double score() const;
+    double llr() const;
+    double lower_bound() const;
+    double upper_bound() const;
+    // -1 accepts H0 (elo0), 1 accepts H1 (elo1), 0 keeps going
+    int decision() const;
+    double elo() const;
+    // half-width of the 95% interval on elo()
+    double elo_margin() const;
+};
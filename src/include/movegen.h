@@ -0,0 +1,48 @@
+#pragma once
+
+#include<cstdint>
+#include<cstddef>
+
+#include "attack_map.h"
+#include "bitboard.h"
+
+const uint8_t CASTLE_WHITE_KING = 1;
+const uint8_t CASTLE_WHITE_QUEEN = 2;
+const uint8_t CASTLE_BLACK_KING = 4;
+const uint8_t CASTLE_BLACK_QUEEN = 8;
+const uint8_t CASTLE_ALL = 15;
+const size_t NO_SQUARE = 64;
+const size_t MAX_MOVES = MAX_NEXT_BOARDS;
+
+// What a full chess position needs beyond the frame's piece boards.
+struct position_state{
+    bool player_to_move {true};
+    uint8_t castling {CASTLE_ALL};
+    size_t en_passant {NO_SQUARE};   // square passed over by the last double push
+};
+
+// Pseudo-legal moves of every piece type for the side to move, including
+// castling, en passant and all four promotions. moves needs MAX_MOVES entries.
+// Unlike the frame successor generators this covers the whole rule set; it
+// serves the search, self-play and replay alike.
+size_t generate_moves(const bitboard_frame& frame, const position_state& state, frame_move* moves);
+
+bool square_attacked(const bitboard_frame& frame, size_t square, size_t by_side_offset);
+bool in_check(const bitboard_frame& frame, size_t side_offset);
+// The mover's king is not left attacked; castling may not start in or pass
+// through check either.
+bool is_legal(const bitboard_frame& frame, const position_state& state, const frame_move& move);
+
+// The same answers from an attack map kept in step with frame. Castling and
+// most moves are settled by ANDs against the map; a move is only played out
+// when the mover is in check, moves a piece an enemy slider reaches, or
+// takes en passant.
+bool is_legal(const bitboard_frame& frame, const position_state& state, const frame_move& move, const attack_map& map);
+
+void make_move(bitboard_frame& frame, position_state& state, const frame_move& move);
+// Also brings map from the old frame to the new one.
+void make_move(bitboard_frame& frame, position_state& state, const frame_move& move, attack_map& map);
+
+// Legal leaf count, for validating generate_moves. Legality comes from an
+// attack map carried down the tree.
+uint64_t perft(const bitboard_frame& frame, const position_state& state, size_t depth);
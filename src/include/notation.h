@@ -0,0 +1,34 @@
+#pragma once
+
+#include<cstddef>
+#include<string>
+#include<string_view>
+
+#include "bitboard.h"
+#include "movegen.h"
+
+const char* const START_FEN = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+// Reads the board and side-to-move fields of a FEN or EPD line. The player
+// side is white. Castling and en passant fields are accepted but not kept,
+// the frame has nowhere to store them.
+bool parse_fen(const std::string& fen, bitboard_frame& frame, bool& player_to_move);
+std::string to_fen(const bitboard_frame& frame, bool player_to_move);
+// Same, keeping castling rights and the en passant square.
+bool parse_fen(const std::string& fen, bitboard_frame& frame, position_state& state);
+std::string to_fen(const bitboard_frame& frame, const position_state& state);
+
+std::string square_name(size_t position);
+// Long algebraic / UCI form, e.g. e2e4 or e7e8q.
+std::string coordinate_move(const frame_move& move);
+// SAN for the move from frame to next, disambiguated against all of the
+// side's successors (next included). Check marks are not produced.
+std::string san_move(const bitboard_frame& frame, const bitboard_frame& next, bool player_to_move, const bitboard_frame* successors, size_t successor_count);
+// SAN for a legal move, disambiguated against the legal ones among
+// generate_moves() output and ending in + or # when it gives check or mate.
+std::string san_move(const bitboard_frame& frame, const position_state& state, const frame_move& move, const frame_move* moves, size_t count);
+
+// Finds the one legal move among generate_moves() output that san names.
+// Accepts check marks and annotations, 0-0 for O-O, and promotions with or
+// without '='. Fails on no match or an ambiguous one. Does not allocate.
+bool resolve_san(const bitboard_frame& frame, const position_state& state, std::string_view san, const frame_move* moves, size_t count, frame_move& move);
@@ -0,0 +1,72 @@
+#pragma once
+
+#include<cstdint>
+#include<cstddef>
+#include<functional>
+#include<string_view>
+
+#include "bitboard.h"
+#include "movegen.h"
+
+// One game's text inside a mapped archive, tags included.
+struct pgn_game_text{
+    const char* text {nullptr};
+    size_t length {0};
+    size_t number {0};      // 1-based position in the archive
+};
+
+struct pgn_game_info{
+    size_t number {0};
+    std::string_view result;    // Result tag, views into the archive
+    std::string_view fen;       // FEN tag, empty for the standard start
+    size_t plies {0};
+    bool complete {false};      // every move resolved
+    std::string_view failed_token;
+};
+
+// The position before a replayed move, and the move.
+struct pgn_ply{
+    const bitboard_frame& frame;
+    const position_state& state;
+    const frame_move& move;
+    size_t ply;
+};
+
+// Called from worker threads; worker is in [0, threads) so callers can keep
+// per-worker accumulators without locking. Either may be left empty.
+struct pgn_callbacks{
+    std::function<void(size_t worker, const pgn_game_info& game, const pgn_ply& ply)> on_move;
+    std::function<void(size_t worker, const pgn_game_info& game)> on_game;
+};
+
+struct pgn_replay_stats{
+    uint64_t games {0};
+    uint64_t plies {0};
+    uint64_t failed_games {0};
+};
+
+// Calls visit for every game in data, in archive order. A game starts at a
+// tag line that follows movetext, or at the start of the data.
+size_t split_pgn_games(const char* data, size_t size, const std::function<void(const pgn_game_text&)>& visit);
+
+// Replays one game, resolving each SAN token against generate_moves() and
+// applying it with make_move(). Stops at the first move that does not
+// resolve. Allocates nothing per move.
+pgn_game_info replay_pgn_game(const pgn_game_text& game, size_t worker, const pgn_callbacks& callbacks);
+
+// Splits on the calling thread and replays on threads workers.
+pgn_replay_stats replay_pgn(const char* data, size_t size, size_t threads, const pgn_callbacks& callbacks);
+
+// Read-only mapping of a whole archive, paged in sequentially.
+struct pgn_archive{
+    const char* data {nullptr};
+    size_t size {0};
+
+    pgn_archive() = default;
+    pgn_archive(const pgn_archive&) = delete;
+    pgn_archive& operator=(const pgn_archive&) = delete;
+    ~pgn_archive();
+
+    bool open(const char* path);
+    void close();
+};
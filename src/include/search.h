@@ -0,0 +1,68 @@
+#pragma once
+
+#include<cstdint>
+#include<cstddef>
+
+#include "bitboard.h"
+#include "frame_arena.h"
+#include "movegen.h"
+#include "transposition.h"
+
+const int32_t MATE_SCORE = 1000000;
+const int32_t MATE_BOUND = MATE_SCORE - 1000;
+const int32_t INFINITE_SCORE = MATE_SCORE + 1;
+const size_t MAX_SEARCH_DEPTH = 64;
+// quiescence stops here; check evasions may in theory alternate forever
+const size_t MAX_SEARCH_PLY = 2*MAX_SEARCH_DEPTH;
+
+struct evaluation_weights{
+    int32_t piece_values[6] {100, 500, 330, 320, 0, 900};   // indexed by *_OFFSET
+    int32_t pawn_advance {4};                                // per row from the start row
+};
+
+int32_t material(const bitboard_frame& frame, size_t side_offset, const evaluation_weights& weights);
+
+// Static score from the side to move's point of view.
+int32_t evaluate(const bitboard_frame& frame, bool player_to_move, const evaluation_weights& weights);
+
+struct search_limits{
+    size_t depth {MAX_SEARCH_DEPTH};
+    uint64_t nodes {0};     // 0 means no node limit
+};
+
+struct search_result{
+    bool found {false};
+    size_t best_index {0};  // into generate_moves() output for the root
+    frame_move move {};
+    int32_t score {0};
+    size_t depth {0};
+    uint64_t nodes {0};     // quiescence nodes included
+    uint64_t qnodes {0};
+};
+
+// Iterative-deepening alpha-beta over the legal moves from generate_moves().
+// A side with no legal move is checkmated or stalemated. Every node carries
+// the attack map of its frame, updated by make_move, which answers checks
+// and most legality tests. Move lists live in the arena, rewound per node
+// and per iteration. Leaves are resolved by a
+// quiescence search over captures and promotions, and over every evasion
+// when in check.
+struct searcher{
+    transposition_table& table;
+    frame_arena& arena;
+    evaluation_weights weights;
+    search_limits limits;
+    uint64_t nodes {0};
+    uint64_t qnodes {0};
+    // skip captures that lose material by static exchange
+    bool see_pruning {true};
+    bool stopped {false};
+    size_t iteration_depth {0};
+    uint16_t root_best_index {TT_NO_MOVE};
+
+    searcher(transposition_table& table, frame_arena& arena, const evaluation_weights& weights=evaluation_weights{});
+
+    search_result search(const bitboard_frame& frame, const position_state& state, const search_limits& limits);
+    int32_t negamax(const bitboard_frame& frame, const position_state& state, const attack_map& map, int depth, int32_t alpha, int32_t beta, size_t ply);
+    int32_t quiesce(const bitboard_frame& frame, const position_state& state, const attack_map& map, int32_t alpha, int32_t beta, size_t ply);
+};
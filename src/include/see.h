@@ -0,0 +1,17 @@
+#pragma once
+
+#include<cstdint>
+#include<cstddef>
+
+#include "bitboard.h"
+
+// Worth more than all other material together, so trading the king never pays.
+const int32_t SEE_KING_VALUE = 20000;
+
+// Static exchange evaluation of side_offset moving from_position to
+// to_position: the material balance after both sides keep recapturing on
+// to_position with their least valuable attacker, each free to stop when
+// continuing would lose. Sliders lined up behind an attacker join the swap
+// once it has left. piece_values is indexed by *_OFFSET; kings always count
+// as SEE_KING_VALUE.
+int32_t static_exchange(const bitboard_frame& frame, size_t side_offset, size_t from_position, size_t to_position, const int32_t* piece_values);
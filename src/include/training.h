@@ -0,0 +1,68 @@
+#pragma once
+
+#include<cstdint>
+#include<cstddef>
+#include<functional>
+
+#include "bitboard.h"
+#include "compressed_board.h"
+#include "match.h"
+#include "movegen.h"
+#include "search.h"
+
+// Records are fixed size: 32 board bytes, the side to move as one byte, the
+// score as little-endian int16 and the result as int8.
+const size_t TRAINING_RECORD_SIZE = 36;
+
+struct training_record{
+    compressed_board board;
+    bool player_to_move {true};
+    int16_t score {0};          // search score from the player's (white's) side
+    int8_t result {GAME_DRAW};  // GAME_WHITE_WIN, GAME_DRAW or GAME_BLACK_WIN
+
+    uint64_t hash() const;
+};
+
+void encode_training_record(const training_record& record, unsigned char* out);
+training_record decode_training_record(const unsigned char* in);
+
+// The static evaluation is only fit on positions it can judge by itself:
+// neither side is in check and the side to move has no legal capture with
+// any piece, en passant included.
+bool is_quiet_position(const bitboard_frame& frame, const position_state& state);
+
+struct training_options{
+    size_t threads {1};
+    size_t positions {1000000};     // stop once the file holds this many records
+    uint64_t nodes {5000};          // per move
+    size_t random_plies {8};        // random legal opening moves, not recorded
+    int32_t max_score {3000};       // positions scored beyond this are skipped
+    size_t hash_mb {2};             // per engine and game
+    uint64_t seed {1};
+    bitboard_frame start;
+    position_state start_state;
+    adjudication_rules rules;
+    evaluation_weights weights;
+};
+
+struct training_stats{
+    uint64_t resumed {0};       // records already in the file
+    uint64_t games {0};
+    uint64_t written {0};
+    uint64_t duplicates {0};
+    uint64_t noisy {0};         // in check, capture available or score out of range
+};
+
+// Game number game of a run: options.random_plies random legal moves from
+// options.start, then fixed-node self-play. Fails when the random moves run
+// into mate or stalemate. Runs number their games from the records already
+// in the file, so a resumed run plays new openings.
+bool play_training_game(const training_options& options, uint64_t game, game_record& record);
+
+// Plays fixed-node self-play games on options.threads workers and appends
+// quiet positions to path until it holds options.positions records. An
+// existing file is resumed: a torn final record is cut off and every
+// record's hash seeds the duplicate filter. Each game's records are written
+// and flushed together. on_game is called under the output lock.
+bool generate_training_data(const char* path, const training_options& options, training_stats& stats,
+    const std::function<void(const training_stats&)>& on_game = nullptr);
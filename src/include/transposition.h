@@ -0,0 +1,39 @@
+#pragma once
+
+#include<atomic>
+#include<cstdint>
+#include<cstddef>
+#include<memory>
+
+const uint8_t TT_BOUND_EXACT = 0;
+const uint8_t TT_BOUND_LOWER = 1;
+const uint8_t TT_BOUND_UPPER = 2;
+const uint16_t TT_NO_MOVE = 0xFFFF;  // above any index a move list can reach
+
+struct tt_data{
+    int32_t score;
+    uint8_t depth;
+    uint8_t bound;
+    uint16_t best_index;  // position of the best move in generate_moves() order
+};
+
+// Lockless table: each slot keeps key^data next to data, so a slot torn by a
+// concurrent writer fails the key check instead of returning mixed fields.
+// Safe to share between search threads.
+struct transposition_table{
+    struct slot{
+        std::atomic<uint64_t> check {0};
+        std::atomic<uint64_t> data {0};
+    };
+
+    std::unique_ptr<slot[]> slots;
+    size_t mask;
+
+    transposition_table(size_t megabytes=16);
+
+    bool probe(uint64_t key, tt_data& found) const;
+    // Depth-preferred within a key, always replaces a different key.
+    void store(uint64_t key, const tt_data& entry);
+    void clear();
+    size_t size() const { return mask+1; }
+};
@@ -0,0 +1,53 @@
+#pragma once
+
+#include<cstdint>
+#include<cstddef>
+
+#include "bitboard.h"
+#include "movegen.h"
+
+// Key layout follows Polyglot: 12 piece kinds * 64 squares, 4 castling keys,
+// 8 en passant files and one side-to-move key.
+const size_t ZOBRIST_PIECE_KEYS = 768;
+const size_t ZOBRIST_CASTLE_OFFSET = 768;
+const size_t ZOBRIST_EN_PASSANT_OFFSET = 772;
+const size_t ZOBRIST_TURN_OFFSET = 780;
+const size_t ZOBRIST_KEY_COUNT = 781;
+
+extern const uint64_t POLYGLOT_RANDOM64[ZOBRIST_KEY_COUNT];
+
+struct zobrist_keys{
+    uint64_t keys[ZOBRIST_KEY_COUNT];
+
+    // Deterministic keys from a splitmix64 stream.
+    zobrist_keys(uint64_t seed=0x9E3779B97F4A7C15);
+
+    // Loads ZOBRIST_KEY_COUNT little-endian keys, e.g. the Polyglot Random64
+    // table, so that hashes match books written by other tools.
+    bool load(const char* path);
+
+    static zobrist_keys& defaults();
+    // The published Random64 table, for keys that match Polyglot books.
+    static zobrist_keys& polyglot();
+};
+
+// Polyglot piece kind: black pawn 0, white pawn 1, black knight 2 ... white king 11.
+// The player side is white.
+constexpr size_t zobrist_piece_kind(size_t side_offset, size_t struct_offset){
+    size_t polyglot_type{0};
+    switch(struct_offset){
+        case PAWN_OFFSET: polyglot_type = 0; break;
+        case KNIGHT_OFFSET: polyglot_type = 1; break;
+        case BISHOP_OFFSET: polyglot_type = 2; break;
+        case ROOK_OFFSET: polyglot_type = 3; break;
+        case QUEEN_OFFSET: polyglot_type = 4; break;
+        case KING_OFFSET: polyglot_type = 5; break;
+    }
+    return polyglot_type*2 + (side_offset == PLAYER_OFFSET? 1 : 0);
+}
+
+uint64_t zobrist_hash(const bitboard_frame& frame, bool player_to_move, const zobrist_keys& keys=zobrist_keys::defaults());
+// Full Polyglot key: pieces, castling rights, the en passant file when a pawn
+// of the side to move stands beside the pawn that just advanced two squares,
+// and the turn.
+uint64_t zobrist_hash(const bitboard_frame& frame, const position_state& state, const zobrist_keys& keys=zobrist_keys::polyglot());
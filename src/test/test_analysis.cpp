@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+#include <set>
+#include <sstream>
+#include <thread>
+#include "analysis.h"
+#include "bounded_queue.h"
+#include "notation.h"
+
+TEST(analysis, parse_lines)
+{
+    analysis_job job;
+    GTEST_ASSERT_EQ(parse_analysis_line("", 1, job), false);
+    GTEST_ASSERT_EQ(parse_analysis_line("  # comment", 2, job), false);
+
+    GTEST_ASSERT_EQ(parse_analysis_line("6k1/r6p/8/8/8/8/5PPP/R5K1 w - - bm Rxa7; id \"hanging.1\";", 3, job), true);
+    GTEST_ASSERT_EQ(job.valid, true);
+    GTEST_ASSERT_EQ(job.index, 3);
+    GTEST_ASSERT_EQ(job.id, "hanging.1");
+    GTEST_ASSERT_EQ(job.fen, "6k1/r6p/8/8/8/8/5PPP/R5K1 w - -");
+    GTEST_ASSERT_EQ(job.state.player_to_move, true);
+    GTEST_ASSERT_EQ(job.state.castling, 0);
+
+    GTEST_ASSERT_EQ(parse_analysis_line("not a position", 4, job), true);
+    GTEST_ASSERT_EQ(job.valid, false);
+    GTEST_ASSERT_EQ(analysis_error_json(job, "invalid position"),
+        "{\"index\":4,\"fen\":\"not a position\",\"error\":\"invalid position\"}");
+}
+
+TEST(analysis, stream_results)
+{
+    std::istringstream in{
+        "# two tactics, the start position and a bad line\n"
+        "6k1/r6p/8/8/8/8/5PPP/R5K1 w - - id \"rook\";\n"
+        "6k1/5ppp/8/8/8/8/8/R5K1 w - - 0 1\n"
+        "\n"
+        + std::string(START_FEN) + "\n"
+        "8/8/8 w\n"};
+    std::ostringstream out;
+    analysis_options options;
+    options.threads = 3;
+    options.queue_capacity = 1;
+    options.hash_mb = 1;
+    options.limits = search_limits{3, 0};
+    GTEST_ASSERT_EQ(analyze_stream(in, out, options), 4);
+
+    std::istringstream lines{out.str()};
+    std::string line;
+    std::set<std::string> seen;
+    while(std::getline(lines, line)){
+        GTEST_ASSERT_EQ(line.front(), '{');
+        GTEST_ASSERT_EQ(line.back(), '}');
+        seen.insert(line);
+    }
+    GTEST_ASSERT_EQ(seen.size(), 4);
+    auto has = [&](const std::string& text){
+        for(auto& l : seen){
+            if(l.find(text) != std::string::npos) return true;
+        }
+        return false;
+    };
+    GTEST_ASSERT_EQ(has("{\"index\":2,\"id\":\"rook\",\"fen\":\"6k1/r6p/8/8/8/8/5PPP/R5K1 w - -\",\"bestmove\":\"a1a7\",\"san\":\"Rxa7\""), true);
+    GTEST_ASSERT_EQ(has("\"index\":3,\"fen\":\"6k1/5ppp/8/8/8/8/8/R5K1 w - -\",\"bestmove\":\"a1a8\",\"san\":\"Ra8#\""), true);
+    GTEST_ASSERT_EQ(has("\"mate\":1,"), true);
+    GTEST_ASSERT_EQ(has("\"index\":5,"), true);
+    GTEST_ASSERT_EQ(has("{\"index\":6,\"fen\":\"8/8/8 w\",\"error\":\"invalid position\"}"), true);
+}
+
+TEST(analysis, bounded_queue_blocks_and_drains)
+{
+    bounded_queue<int> queue{2};
+    GTEST_ASSERT_EQ(queue.push(1), true);
+    GTEST_ASSERT_EQ(queue.push(2), true);
+    std::thread producer([&](){
+        queue.push(3);  // waits for room
+        queue.close();
+    });
+    int value;
+    GTEST_ASSERT_EQ(queue.pop(value), true);
+    GTEST_ASSERT_EQ(value, 1);
+    producer.join();
+    GTEST_ASSERT_EQ(queue.push(4), false);
+    GTEST_ASSERT_EQ(queue.pop(value), true);
+    GTEST_ASSERT_EQ(queue.pop(value), true);
+    GTEST_ASSERT_EQ(value, 3);
+    GTEST_ASSERT_EQ(queue.pop(value), false);
+}
@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+#include <cstring>
+#include "attack_map.h"
+#include "attacks.h"
+#include "movegen.h"
+#include "notation.h"
+
+namespace{
+bool same_map(const attack_map& a, const attack_map& b){
+    return std::memcmp(a.from_square, b.from_square, sizeof(a.from_square)) == 0
+        && std::memcmp(a.attacked, b.attacked, sizeof(a.attacked)) == 0
+        && std::memcmp(a.counts, b.counts, sizeof(a.counts)) == 0;
+}
+
+// Walks every legal line to depth, updating the map move by move and
+// comparing it, and the legality it decides, with a fresh build and the
+// played-out check. Returns the positions checked.
+uint64_t check_updates(const bitboard_frame& frame, const position_state& state, const attack_map& map, size_t depth){
+    attack_map built{frame};
+    EXPECT_TRUE(same_map(map, built)) << to_fen(frame, state);
+    EXPECT_EQ(std::memcmp(map.slider_attacked, built.slider_attacked, sizeof(map.slider_attacked)), 0);
+    for(size_t side=0; side<SIDES; ++side){
+        EXPECT_EQ(map.in_check(frame, side), in_check(frame, side));
+    }
+    if(depth == 0){
+        return 1;
+    }
+    frame_move moves[MAX_MOVES];
+    auto count {generate_moves(frame, state, moves)};
+    uint64_t checked{1};
+    for(size_t i=0; i<count; ++i){
+        auto legal {is_legal(frame, state, moves[i])};
+        EXPECT_EQ(is_legal(frame, state, moves[i], map), legal) << to_fen(frame, state) << " " << coordinate_move(moves[i]);
+        if(!legal){
+            continue;
+        }
+        auto next {frame};
+        auto next_state {state};
+        auto next_map {map};
+        make_move(next, next_state, moves[i], next_map);
+        checked += check_updates(next, next_state, next_map, depth-1);
+    }
+    return checked;
+}
+}
+
+TEST(attack_map, build)
+{
+    bitboard_frame frame;
+    attack_map map{frame};
+    // the start position attacks its own third row and nothing beyond
+    GTEST_ASSERT_EQ(map.attacked[PLAYER_OFFSET] & 0xFF0000, 0xFF0000);
+    GTEST_ASSERT_EQ(map.attacked[PLAYER_OFFSET] & ~(uint64_t)0xFFFFFF, 0);
+    GTEST_ASSERT_EQ(map.counts[PLAYER_OFFSET][compute_distance(2, 2)], 3);     // b2, d2 and b1
+    GTEST_ASSERT_EQ(map.counts[PLAYER_OFFSET][compute_distance(0, 0)], 0);
+    GTEST_ASSERT_EQ(map.is_attacked(OPPONENT_OFFSET, compute_distance(5, 5)), true);
+    GTEST_ASSERT_EQ(map.in_check(frame, PLAYER_OFFSET), false);
+
+    position_state state;
+    parse_fen("4k3/8/8/8/1b6/8/3P4/4K3 w - - 0 1", frame, state);
+    map.build(frame);
+    GTEST_ASSERT_EQ(map.in_check(frame, PLAYER_OFFSET), false);
+    for(size_t square=0; square<BOARDSIZE*BOARDSIZE; ++square){
+        for(size_t side=0; side<SIDES; ++side){
+            auto attackers {attackers_to(frame, square, frame.occupied) & frame.side(side).occupancy};
+            GTEST_ASSERT_EQ(map.counts[side][square], __builtin_popcountll(attackers));
+        }
+    }
+}
+
+TEST(attack_map, incremental_updates)
+{
+    const char* positions[] {
+        START_FEN,
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+        "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+    };
+    for(auto fen : positions){
+        bitboard_frame frame;
+        position_state state;
+        GTEST_ASSERT_EQ(parse_fen(fen, frame, state), true);
+        GTEST_ASSERT_GT(check_updates(frame, state, attack_map{frame}, 2), 1);
+    }
+}
@@ -17,16 +17,16 @@ size_t count_bits(uint64_t board){
 
 std::set<uint64_t> get_player_board_set(const std::vector<bitboard_frame>& moves, size_t struct_offset){
     std::set<uint64_t> board_set;
-    for(auto b: moves){
-        board_set.emplace(reinterpret_cast<uint64_t*>(&b)[struct_offset]);
+    for(auto& b: moves){
+        board_set.emplace(b.player.pieces[struct_offset]);
     }
     return board_set;
 }
 
 std::set<uint64_t> get_opp_board_set(const std::vector<bitboard_frame>& moves, size_t struct_offset){
     std::set<uint64_t> board_set;
-    for(auto b: moves){
-        board_set.emplace(reinterpret_cast<uint64_t*>(&b.opponent)[struct_offset]);
+    for(auto& b: moves){
+        board_set.emplace(b.opponent.pieces[struct_offset]);
     }
     return board_set;
 }
@@ -47,31 +47,53 @@ TEST(bitboard, compute_distance)
 
 TEST(bitboard, move)
 {
-    bitboard_player_set bb;
-    GTEST_ASSERT_GT(bb.pawns &(uint64_t)(1)<<9,0);
-    GTEST_ASSERT_EQ(bb.pawns &(uint64_t)(1)<<1,0);
-    GTEST_ASSERT_EQ(count_bits(bb.pawns),8);
-
-    bb.move_piece((size_t)PAWN_OFFSET, (size_t)9, (size_t)1);
-    GTEST_ASSERT_EQ(bb.pawns &(uint64_t)(1)<<9,0);
-    GTEST_ASSERT_GT(bb.pawns &(uint64_t)(1)<<1,0);
-    GTEST_ASSERT_EQ(count_bits(bb.pawns),8);
+    bitboard_frame bb;
+    auto& pawns {bb.player.pieces[PAWN_OFFSET]};
+    GTEST_ASSERT_GT(pawns &(uint64_t)(1)<<9,0);
+    GTEST_ASSERT_EQ(pawns &(uint64_t)(1)<<1,0);
+    GTEST_ASSERT_EQ(count_bits(pawns),8);
+
+    bb.remove_pieces(PLAYER_OFFSET, (size_t)1);
+    bb.move_piece(PLAYER_OFFSET, (size_t)PAWN_OFFSET, (size_t)9, (size_t)1);
+    GTEST_ASSERT_EQ(pawns &(uint64_t)(1)<<9,0);
+    GTEST_ASSERT_GT(pawns &(uint64_t)(1)<<1,0);
+    GTEST_ASSERT_EQ(count_bits(pawns),8);
+    GTEST_ASSERT_EQ(bb.player.occupancy &(uint64_t)(1)<<9,0);
+    GTEST_ASSERT_GT(bb.occupied &(uint64_t)(1)<<1,0);
 }
 
 TEST(bitboard, remove)
 {
-    bitboard_player_set bb;
-    GTEST_ASSERT_GT(bb.pawns &(uint64_t)(1)<<9,0);
-    GTEST_ASSERT_EQ(bb.pawns &(uint64_t)(1)<<1,0);
-    GTEST_ASSERT_EQ(count_bits(bb.pawns),8);
-
-    bb.remove_piece((size_t)PAWN_OFFSET, (size_t)9);
-    GTEST_ASSERT_EQ(bb.pawns &(uint64_t)(1)<<9,0);
-    GTEST_ASSERT_EQ(count_bits(bb.pawns),7);
-
-    bb.remove_piece((size_t)PAWN_OFFSET, (size_t)1);
-    GTEST_ASSERT_EQ(bb.pawns &(uint64_t)(1)<<1,0);
-    GTEST_ASSERT_EQ(count_bits(bb.pawns),7);
+    bitboard_frame bb;
+    auto& pawns {bb.player.pieces[PAWN_OFFSET]};
+    GTEST_ASSERT_GT(pawns &(uint64_t)(1)<<9,0);
+    GTEST_ASSERT_EQ(pawns &(uint64_t)(1)<<1,0);
+    GTEST_ASSERT_EQ(count_bits(pawns),8);
+
+    bb.remove_piece(PLAYER_OFFSET, (size_t)PAWN_OFFSET, (size_t)9);
+    GTEST_ASSERT_EQ(pawns &(uint64_t)(1)<<9,0);
+    GTEST_ASSERT_EQ(count_bits(pawns),7);
+    GTEST_ASSERT_EQ(bb.occupied &(uint64_t)(1)<<9,0);
+
+    bb.remove_piece(PLAYER_OFFSET, (size_t)PAWN_OFFSET, (size_t)1);
+    GTEST_ASSERT_EQ(pawns &(uint64_t)(1)<<1,0);
+    GTEST_ASSERT_EQ(count_bits(pawns),7);
+    GTEST_ASSERT_GT(bb.occupied &(uint64_t)(1)<<1,0);
+}
+
+TEST(bitboard, occupancy)
+{
+    bitboard_frame bb;
+    GTEST_ASSERT_EQ(bb.player.occupancy, start_pawns(0) | start_pawns(1));
+    GTEST_ASSERT_EQ(bb.opponent.occupancy, start_pawns(6) | start_pawns(7));
+    GTEST_ASSERT_EQ(bb.occupied, bb.player.occupancy | bb.opponent.occupancy);
+    GTEST_ASSERT_EQ(reinterpret_cast<uintptr_t>(&bb)%64, 0);
+
+    bb.remove_pieces(OPPONENT_OFFSET, (size_t)63);
+    GTEST_ASSERT_EQ(bb.piece_at(OPPONENT_OFFSET, 63), NO_PIECE_OFFSET);
+    GTEST_ASSERT_EQ(bb.occupied &(uint64_t)(1)<<63,0);
+    bb.clear();
+    GTEST_ASSERT_EQ(bb.occupied, 0);
 }
 
 TEST(bitboard, start_vals)
@@ -126,25 +148,21 @@ TEST(bitboard, start_vals)
 
 TEST(bitboard, test_pawn_moves)
 {
-    bitboard_player_set bb;
-    bb.rooks = 0;
-    bb.knights = 0;
-    bb.bishops = 0;
-    bb.king = 0;
-    bb.queen = 0;
-    bitboard_player_set bbo(true);
-    bitboard_frame frm(bb,bbo);
+    bitboard_frame frm;
+    for(auto piece : {ROOK_OFFSET, KNIGHT_OFFSET, BISHOP_OFFSET, KING_OFFSET, QUEEN_OFFSET}){
+        frm.set_pieces(PLAYER_OFFSET, piece, 0);
+    }
 
     auto moves = frm.get_next_boards();
     GTEST_ASSERT_EQ(moves.size(), 16);
-    GTEST_ASSERT_EQ(count_bits(frm.player.pawns), 8);
+    GTEST_ASSERT_EQ(count_bits(frm.player.pieces[PAWN_OFFSET]), 8);
 
 
     //test two space basic moves
-    frm.player.pawns = ((uint64_t) 1)<<8;
+    frm.set_pieces(PLAYER_OFFSET, PAWN_OFFSET, ((uint64_t) 1)<<8);
     moves = frm.get_next_boards();
     GTEST_ASSERT_EQ(moves.size(), 2);
-    GTEST_ASSERT_EQ(count_bits(frm.player.pawns), 1);
+    GTEST_ASSERT_EQ(count_bits(frm.player.pieces[PAWN_OFFSET]), 1);
     std::set<uint64_t> board_lookup {get_player_board_set(moves, PAWN_OFFSET)};
     GTEST_ASSERT_NE(board_lookup.find(((uint64_t) 1)<<16), board_lookup.end());
     GTEST_ASSERT_NE(board_lookup.find(((uint64_t) 1)<<24), board_lookup.end());
@@ -152,100 +170,100 @@ TEST(bitboard, test_pawn_moves)
     GTEST_ASSERT_EQ(board_lookup.find(((uint64_t) 1)<<17), board_lookup.end());
 
     //test only one space available away from starting row
-    frm.opponent.pawns = 0;
-    frm.opponent.rooks = 0;
-    frm.opponent.knights = 0;
+    frm.set_pieces(OPPONENT_OFFSET, PAWN_OFFSET, 0);
+    frm.set_pieces(OPPONENT_OFFSET, ROOK_OFFSET, 0);
+    frm.set_pieces(OPPONENT_OFFSET, KNIGHT_OFFSET, 0);
     for(auto v : std::vector<size_t>{16,24,32,40,48}){
-        frm.player.pawns = ((uint64_t) 1)<<v;
+        frm.set_pieces(PLAYER_OFFSET, PAWN_OFFSET, ((uint64_t) 1)<<v);
         moves = frm.get_next_boards();
         GTEST_ASSERT_EQ(moves.size(), 1);
-        GTEST_ASSERT_EQ(count_bits(frm.player.pawns), 1);
-        GTEST_ASSERT_EQ(count_bits(moves[0].player.pawns), 1);
-        GTEST_ASSERT_EQ(moves[0].player.pawns, ((uint64_t) 1)<<(v+8));
+        GTEST_ASSERT_EQ(count_bits(frm.player.pieces[PAWN_OFFSET]), 1);
+        GTEST_ASSERT_EQ(count_bits(moves[0].player.pieces[PAWN_OFFSET]), 1);
+        GTEST_ASSERT_EQ(moves[0].player.pieces[PAWN_OFFSET], ((uint64_t) 1)<<(v+8));
     }
     //no moves at edge
-    frm.player.pawns = ((uint64_t) 1)<<56;
+    frm.set_pieces(PLAYER_OFFSET, PAWN_OFFSET, ((uint64_t) 1)<<56);
     moves = frm.get_next_boards();
     GTEST_ASSERT_EQ(moves.size(), 0);
 
     //test no moves if blocked on front
-    frm.player.pawns = ((uint64_t) 1)<<8;
-    frm.opponent.pawns = ((uint64_t) 1)<<16;
+    frm.set_pieces(PLAYER_OFFSET, PAWN_OFFSET, ((uint64_t) 1)<<8);
+    frm.set_pieces(OPPONENT_OFFSET, PAWN_OFFSET, ((uint64_t) 1)<<16);
     moves = frm.get_next_boards();
     GTEST_ASSERT_EQ(moves.size(), 0);
-    GTEST_ASSERT_EQ(count_bits(frm.player.pawns), 1);
-    GTEST_ASSERT_EQ(count_bits(frm.opponent.pawns), 1);
+    GTEST_ASSERT_EQ(count_bits(frm.player.pieces[PAWN_OFFSET]), 1);
+    GTEST_ASSERT_EQ(count_bits(frm.opponent.pieces[PAWN_OFFSET]), 1);
 
     //test move available if strikeable added
-    frm.opponent.pawns |= ((uint64_t) 1)<<17;
+    frm.set_pieces(OPPONENT_OFFSET, PAWN_OFFSET, frm.opponent.pieces[PAWN_OFFSET] | ((uint64_t) 1)<<17);
     moves = frm.get_next_boards();
     GTEST_ASSERT_EQ(moves.size(), 1);
-    GTEST_ASSERT_EQ(count_bits(frm.player.pawns), 1);
-    GTEST_ASSERT_EQ(count_bits(frm.opponent.pawns), 2);
-    GTEST_ASSERT_EQ(moves[0].player.pawns, ((uint64_t) 1)<<17);
+    GTEST_ASSERT_EQ(count_bits(frm.player.pieces[PAWN_OFFSET]), 1);
+    GTEST_ASSERT_EQ(count_bits(frm.opponent.pieces[PAWN_OFFSET]), 2);
+    GTEST_ASSERT_EQ(moves[0].player.pieces[PAWN_OFFSET], ((uint64_t) 1)<<17);
 
     //test moves does not strike on same row
-    frm.opponent.pawns = ((uint64_t) 1)<<15;
+    frm.set_pieces(OPPONENT_OFFSET, PAWN_OFFSET, ((uint64_t) 1)<<15);
     moves = frm.get_next_boards();
     GTEST_ASSERT_EQ(moves.size(), 2);
-    GTEST_ASSERT_EQ(count_bits(frm.player.pawns), 1);
+    GTEST_ASSERT_EQ(count_bits(frm.player.pieces[PAWN_OFFSET]), 1);
     for(auto m: moves){
-        GTEST_ASSERT_EQ(count_bits(m.player.pawns), 1);
-        GTEST_ASSERT_EQ(count_bits(m.opponent.pawns), 1);
+        GTEST_ASSERT_EQ(count_bits(m.player.pieces[PAWN_OFFSET]), 1);
+        GTEST_ASSERT_EQ(count_bits(m.opponent.pieces[PAWN_OFFSET]), 1);
     }
 
     //test all three moves available when strike is present
-    frm.opponent.pawns = ((uint64_t) 1)<<17;
+    frm.set_pieces(OPPONENT_OFFSET, PAWN_OFFSET, ((uint64_t) 1)<<17);
     moves = frm.get_next_boards();
     GTEST_ASSERT_EQ(moves.size(), 3);
-    GTEST_ASSERT_EQ(count_bits(frm.player.pawns), 1);
+    GTEST_ASSERT_EQ(count_bits(frm.player.pieces[PAWN_OFFSET]), 1);
     size_t strike_moves = 0;
     for(auto m: moves){
-        GTEST_ASSERT_EQ(count_bits(m.player.pawns), 1);
-        if(m.opponent.pawns){
-            GTEST_ASSERT_EQ(count_bits(m.opponent.pawns), 1);
+        GTEST_ASSERT_EQ(count_bits(m.player.pieces[PAWN_OFFSET]), 1);
+        if(m.opponent.pieces[PAWN_OFFSET]){
+            GTEST_ASSERT_EQ(count_bits(m.opponent.pieces[PAWN_OFFSET]), 1);
         }
         else{
-             GTEST_ASSERT_EQ(m.player.pawns, ((uint64_t) 1)<<17);
+             GTEST_ASSERT_EQ(m.player.pieces[PAWN_OFFSET], ((uint64_t) 1)<<17);
              ++strike_moves;
         }
     }
     GTEST_ASSERT_EQ(strike_moves, 1);
 
     //test strikeable 
-    frm.player.pawns = ((uint64_t) 1)<<11;
-    frm.opponent.pawns = ((uint64_t) 1)<<18;
+    frm.set_pieces(PLAYER_OFFSET, PAWN_OFFSET, ((uint64_t) 1)<<11);
+    frm.set_pieces(OPPONENT_OFFSET, PAWN_OFFSET, ((uint64_t) 1)<<18);
     moves = frm.get_next_boards();
     board_lookup = get_player_board_set(moves, PAWN_OFFSET);
     GTEST_ASSERT_EQ(moves.size(), 3);
-    GTEST_ASSERT_EQ(count_bits(frm.player.pawns), 1);
+    GTEST_ASSERT_EQ(count_bits(frm.player.pieces[PAWN_OFFSET]), 1);
     strike_moves = 0;
     for(auto m: moves){
-        GTEST_ASSERT_EQ(count_bits(m.player.pawns), 1);
-        if(m.opponent.pawns){
-            GTEST_ASSERT_EQ(count_bits(m.opponent.pawns), 1);
+        GTEST_ASSERT_EQ(count_bits(m.player.pieces[PAWN_OFFSET]), 1);
+        if(m.opponent.pieces[PAWN_OFFSET]){
+            GTEST_ASSERT_EQ(count_bits(m.opponent.pieces[PAWN_OFFSET]), 1);
         }
         else{
-             GTEST_ASSERT_GT(m.player.pawns & ((uint64_t) 1)<<18, 0);
+             GTEST_ASSERT_GT(m.player.pieces[PAWN_OFFSET] & ((uint64_t) 1)<<18, 0);
              ++strike_moves;
         }
     }
     GTEST_ASSERT_EQ(strike_moves, 1);
 
     //test strikeable from  two pawns
-    frm.player.pawns |= ((uint64_t) 1)<<9;
+    frm.set_pieces(PLAYER_OFFSET, PAWN_OFFSET, frm.player.pieces[PAWN_OFFSET] | ((uint64_t) 1)<<9);
     moves = frm.get_next_boards();
     board_lookup = get_player_board_set(moves, PAWN_OFFSET);
     GTEST_ASSERT_EQ(moves.size(), 6);
-    GTEST_ASSERT_EQ(count_bits(frm.player.pawns), 2);
+    GTEST_ASSERT_EQ(count_bits(frm.player.pieces[PAWN_OFFSET]), 2);
     strike_moves = 0;
     for(auto m: moves){
-        GTEST_ASSERT_EQ(count_bits(m.player.pawns), 2);
-        if(m.opponent.pawns){
-            GTEST_ASSERT_EQ(count_bits(m.opponent.pawns), 1);
+        GTEST_ASSERT_EQ(count_bits(m.player.pieces[PAWN_OFFSET]), 2);
+        if(m.opponent.pieces[PAWN_OFFSET]){
+            GTEST_ASSERT_EQ(count_bits(m.opponent.pieces[PAWN_OFFSET]), 1);
         }
         else{
-            GTEST_ASSERT_GT(m.player.pawns & ((uint64_t) 1)<<18, 0);
+            GTEST_ASSERT_GT(m.player.pieces[PAWN_OFFSET] & ((uint64_t) 1)<<18, 0);
              ++strike_moves;
         }
     }
@@ -254,24 +272,20 @@ TEST(bitboard, test_pawn_moves)
 
 TEST(bitboard, test_opponent_pawn_moves)
 {
-    bitboard_player_set bb;
-    bitboard_player_set bbo(true);
-    bbo.rooks = 0;
-    bbo.knights = 0;
-    bbo.bishops = 0;
-    bbo.king = 0;
-    bbo.queen = 0;
-    bitboard_frame frm(bb,bbo);
+    bitboard_frame frm;
+    for(auto piece : {ROOK_OFFSET, KNIGHT_OFFSET, BISHOP_OFFSET, KING_OFFSET, QUEEN_OFFSET}){
+        frm.set_pieces(OPPONENT_OFFSET, piece, 0);
+    }
 
     auto moves = frm.get_opponent_next_boards();
     GTEST_ASSERT_EQ(moves.size(), 16);
-    GTEST_ASSERT_EQ(count_bits(frm.opponent.pawns), 8);
+    GTEST_ASSERT_EQ(count_bits(frm.opponent.pieces[PAWN_OFFSET]), 8);
 
     //test two space basic moves
-    frm.opponent.pawns = ((uint64_t) 1)<<54;
+    frm.set_pieces(OPPONENT_OFFSET, PAWN_OFFSET, ((uint64_t) 1)<<54);
     moves = frm.get_opponent_next_boards();
     GTEST_ASSERT_EQ(moves.size(), 2);
-    GTEST_ASSERT_EQ(count_bits(frm.opponent.pawns), 1);
+    GTEST_ASSERT_EQ(count_bits(frm.opponent.pieces[PAWN_OFFSET]), 1);
     std::set<uint64_t> board_lookup {get_opp_board_set(moves, PAWN_OFFSET)};
     GTEST_ASSERT_NE(board_lookup.find(((uint64_t) 1)<<46), board_lookup.end());
     GTEST_ASSERT_NE(board_lookup.find(((uint64_t) 1)<<38), board_lookup.end());
@@ -279,98 +293,98 @@ TEST(bitboard, test_opponent_pawn_moves)
     GTEST_ASSERT_EQ(board_lookup.find(((uint64_t) 1)<<47), board_lookup.end());
 
     //test only one space available away from starting row
-    frm.player.pawns = 0;
-    frm.player.rooks = 0;
-    frm.player.knights = 0;
+    frm.set_pieces(PLAYER_OFFSET, PAWN_OFFSET, 0);
+    frm.set_pieces(PLAYER_OFFSET, ROOK_OFFSET, 0);
+    frm.set_pieces(PLAYER_OFFSET, KNIGHT_OFFSET, 0);
     for(auto v : std::vector<size_t>{8,16,24,32}){
-        frm.opponent.pawns = ((uint64_t) 1)<<v;
+        frm.set_pieces(OPPONENT_OFFSET, PAWN_OFFSET, ((uint64_t) 1)<<v);
         moves = frm.get_opponent_next_boards();
         GTEST_ASSERT_EQ(moves.size(), 1);
-        GTEST_ASSERT_EQ(count_bits(frm.opponent.pawns), 1);
-        GTEST_ASSERT_EQ(count_bits(moves[0].opponent.pawns), 1);
-        GTEST_ASSERT_EQ(moves[0].opponent.pawns, ((uint64_t) 1)<<(v-8));
+        GTEST_ASSERT_EQ(count_bits(frm.opponent.pieces[PAWN_OFFSET]), 1);
+        GTEST_ASSERT_EQ(count_bits(moves[0].opponent.pieces[PAWN_OFFSET]), 1);
+        GTEST_ASSERT_EQ(moves[0].opponent.pieces[PAWN_OFFSET], ((uint64_t) 1)<<(v-8));
     }
     //no moves at edge
-    frm.opponent.pawns = ((uint64_t) 1)<<0;
+    frm.set_pieces(OPPONENT_OFFSET, PAWN_OFFSET, ((uint64_t) 1)<<0);
     moves = frm.get_opponent_next_boards();
     GTEST_ASSERT_EQ(moves.size(), 0);
 
     //test no moves if blocked on front
-    frm.player.pawns = ((uint64_t) 1)<<47;
-    frm.opponent.pawns = ((uint64_t) 1)<<55;
+    frm.set_pieces(PLAYER_OFFSET, PAWN_OFFSET, ((uint64_t) 1)<<47);
+    frm.set_pieces(OPPONENT_OFFSET, PAWN_OFFSET, ((uint64_t) 1)<<55);
     moves = frm.get_opponent_next_boards();
     GTEST_ASSERT_EQ(moves.size(), 0);
-    GTEST_ASSERT_EQ(count_bits(frm.player.pawns), 1);
-    GTEST_ASSERT_EQ(count_bits(frm.opponent.pawns), 1);
+    GTEST_ASSERT_EQ(count_bits(frm.player.pieces[PAWN_OFFSET]), 1);
+    GTEST_ASSERT_EQ(count_bits(frm.opponent.pieces[PAWN_OFFSET]), 1);
 
     //test move available if strikeable added
-    frm.player.pawns |= ((uint64_t) 1)<<46;
+    frm.set_pieces(PLAYER_OFFSET, PAWN_OFFSET, frm.player.pieces[PAWN_OFFSET] | ((uint64_t) 1)<<46);
     moves = frm.get_opponent_next_boards();
     GTEST_ASSERT_EQ(moves.size(), 1);
-    GTEST_ASSERT_EQ(count_bits(frm.opponent.pawns), 1);
-    GTEST_ASSERT_EQ(count_bits(frm.player.pawns), 2);
-    GTEST_ASSERT_EQ(moves[0].opponent.pawns, ((uint64_t) 1)<<46);
+    GTEST_ASSERT_EQ(count_bits(frm.opponent.pieces[PAWN_OFFSET]), 1);
+    GTEST_ASSERT_EQ(count_bits(frm.player.pieces[PAWN_OFFSET]), 2);
+    GTEST_ASSERT_EQ(moves[0].opponent.pieces[PAWN_OFFSET], ((uint64_t) 1)<<46);
 
     //test moves does not strike on same row
-    frm.player.pawns = ((uint64_t) 1)<<48;
+    frm.set_pieces(PLAYER_OFFSET, PAWN_OFFSET, ((uint64_t) 1)<<48);
     moves = frm.get_opponent_next_boards();
     GTEST_ASSERT_EQ(moves.size(), 2);
-    GTEST_ASSERT_EQ(count_bits(frm.opponent.pawns), 1);
+    GTEST_ASSERT_EQ(count_bits(frm.opponent.pieces[PAWN_OFFSET]), 1);
     for(auto m: moves){
-        GTEST_ASSERT_EQ(count_bits(m.player.pawns), 1);
-        GTEST_ASSERT_EQ(count_bits(m.opponent.pawns), 1);
+        GTEST_ASSERT_EQ(count_bits(m.player.pieces[PAWN_OFFSET]), 1);
+        GTEST_ASSERT_EQ(count_bits(m.opponent.pieces[PAWN_OFFSET]), 1);
     }
 
     //test all three moves available when strike is present
-    frm.player.pawns = ((uint64_t) 1)<<46;
+    frm.set_pieces(PLAYER_OFFSET, PAWN_OFFSET, ((uint64_t) 1)<<46);
     moves = frm.get_opponent_next_boards();
     GTEST_ASSERT_EQ(moves.size(), 3);
-    GTEST_ASSERT_EQ(count_bits(frm.player.pawns), 1);
+    GTEST_ASSERT_EQ(count_bits(frm.player.pieces[PAWN_OFFSET]), 1);
     size_t strike_moves = 0;
     for(auto m: moves){
-        GTEST_ASSERT_EQ(count_bits(m.opponent.pawns), 1);
-        if(m.player.pawns){
-            GTEST_ASSERT_EQ(count_bits(m.player.pawns), 1);
+        GTEST_ASSERT_EQ(count_bits(m.opponent.pieces[PAWN_OFFSET]), 1);
+        if(m.player.pieces[PAWN_OFFSET]){
+            GTEST_ASSERT_EQ(count_bits(m.player.pieces[PAWN_OFFSET]), 1);
         }
         else{
-             GTEST_ASSERT_EQ(m.opponent.pawns, ((uint64_t) 1)<<46);
+             GTEST_ASSERT_EQ(m.opponent.pieces[PAWN_OFFSET], ((uint64_t) 1)<<46);
              ++strike_moves;
         }
     }
     GTEST_ASSERT_EQ(strike_moves, 1);
 
     //test strikeable 
-    frm.player.pawns = ((uint64_t) 1)<<45;
-    frm.opponent.pawns = ((uint64_t) 1)<<52;
+    frm.set_pieces(PLAYER_OFFSET, PAWN_OFFSET, ((uint64_t) 1)<<45);
+    frm.set_pieces(OPPONENT_OFFSET, PAWN_OFFSET, ((uint64_t) 1)<<52);
     moves = frm.get_opponent_next_boards();
     GTEST_ASSERT_EQ(moves.size(), 3);
-    GTEST_ASSERT_EQ(count_bits(frm.opponent.pawns), 1);
+    GTEST_ASSERT_EQ(count_bits(frm.opponent.pieces[PAWN_OFFSET]), 1);
     strike_moves = 0;
     for(auto m: moves){
-        GTEST_ASSERT_EQ(count_bits(m.opponent.pawns), 1);
-        if(m.player.pawns){
-            GTEST_ASSERT_EQ(count_bits(m.player.pawns), 1);
+        GTEST_ASSERT_EQ(count_bits(m.opponent.pieces[PAWN_OFFSET]), 1);
+        if(m.player.pieces[PAWN_OFFSET]){
+            GTEST_ASSERT_EQ(count_bits(m.player.pieces[PAWN_OFFSET]), 1);
         }
         else{
-             GTEST_ASSERT_GT(m.opponent.pawns & ((uint64_t) 1)<<45, 0);
+             GTEST_ASSERT_GT(m.opponent.pieces[PAWN_OFFSET] & ((uint64_t) 1)<<45, 0);
              ++strike_moves;
         }
     }
     GTEST_ASSERT_EQ(strike_moves, 1);
 
     //test strikeable from two pawns
-    frm.opponent.pawns |= ((uint64_t) 1)<<54;
+    frm.set_pieces(OPPONENT_OFFSET, PAWN_OFFSET, frm.opponent.pieces[PAWN_OFFSET] | ((uint64_t) 1)<<54);
     moves = frm.get_opponent_next_boards();
     GTEST_ASSERT_EQ(moves.size(), 6);
-    GTEST_ASSERT_EQ(count_bits(frm.opponent.pawns), 2);
+    GTEST_ASSERT_EQ(count_bits(frm.opponent.pieces[PAWN_OFFSET]), 2);
     strike_moves = 0;
     for(auto m: moves){
-        GTEST_ASSERT_EQ(count_bits(m.opponent.pawns), 2);
-        if(m.player.pawns){
-            GTEST_ASSERT_EQ(count_bits(m.player.pawns), 1);
+        GTEST_ASSERT_EQ(count_bits(m.opponent.pieces[PAWN_OFFSET]), 2);
+        if(m.player.pieces[PAWN_OFFSET]){
+            GTEST_ASSERT_EQ(count_bits(m.player.pieces[PAWN_OFFSET]), 1);
         }
         else{
-            GTEST_ASSERT_GT(m.opponent.pawns & ((uint64_t) 1)<<45, 0);
+            GTEST_ASSERT_GT(m.opponent.pieces[PAWN_OFFSET] & ((uint64_t) 1)<<45, 0);
              ++strike_moves;
         }
     }
@@ -378,6 +392,39 @@ TEST(bitboard, test_opponent_pawn_moves)
 }
 
 
+TEST(bitboard, test_rook_moves)
+{
+    auto frm {bitboard_frame::empty()};
+    frm.set_pieces(PLAYER_OFFSET, ROOK_OFFSET, ((uint64_t) 1)<<7);
+    frm.set_pieces(OPPONENT_OFFSET, ROOK_OFFSET, ((uint64_t) 1)<<56);
+    frm.set_pieces(OPPONENT_OFFSET, KNIGHT_OFFSET, ((uint64_t) 1)<<63);
+
+    //h1 rook: seven left along the row, seven up the file ending on the knight strike
+    auto moves = frm.get_next_boards();
+    GTEST_ASSERT_EQ(moves.size(), 14);
+    std::set<uint64_t> board_lookup {get_player_board_set(moves, ROOK_OFFSET)};
+    GTEST_ASSERT_EQ(board_lookup.find(((uint64_t) 1)<<8), board_lookup.end());
+    GTEST_ASSERT_NE(board_lookup.find(((uint64_t) 1)<<63), board_lookup.end());
+    size_t strike_moves = 0;
+    for(auto m: moves){
+        GTEST_ASSERT_EQ(count_bits(m.player.pieces[ROOK_OFFSET]), 1);
+        if(!m.opponent.pieces[KNIGHT_OFFSET]){
+            ++strike_moves;
+        }
+    }
+    GTEST_ASSERT_EQ(strike_moves, 1);
+
+    //a8 rook moves itself, not the player's rook
+    moves = frm.get_opponent_next_boards();
+    GTEST_ASSERT_EQ(moves.size(), 13);
+    board_lookup = get_opp_board_set(moves, ROOK_OFFSET);
+    GTEST_ASSERT_EQ(board_lookup.find(((uint64_t) 1)<<55), board_lookup.end());
+    GTEST_ASSERT_NE(board_lookup.find(((uint64_t) 1)<<0), board_lookup.end());
+    for(auto m: moves){
+        GTEST_ASSERT_EQ(m.player.pieces[ROOK_OFFSET], ((uint64_t) 1)<<7);
+        GTEST_ASSERT_EQ(count_bits(m.opponent.pieces[ROOK_OFFSET]), 1);
+    }
+}
 
 int main(int argc, char* argv[])
 {
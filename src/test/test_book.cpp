@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <random>
+#include <sstream>
+#include "book.h"
+#include "notation.h"
+#include "zobrist.h"
+
+TEST(zobrist, side_and_transposition)
+{
+    bitboard_frame start;
+    GTEST_ASSERT_NE(zobrist_hash(start, true), zobrist_hash(start, false));
+
+    // g1f3 g8f6 b1c3 and b1c3 g8f6 g1f3 reach the same position
+    auto first {start.clone_from_played_move(PLAYER_OFFSET, 6, 21)
+        .clone_from_played_move(OPPONENT_OFFSET, 62, 45)
+        .clone_from_played_move(PLAYER_OFFSET, 1, 18)};
+    auto second {start.clone_from_played_move(PLAYER_OFFSET, 1, 18)
+        .clone_from_played_move(OPPONENT_OFFSET, 62, 45)
+        .clone_from_played_move(PLAYER_OFFSET, 6, 21)};
+    GTEST_ASSERT_EQ(zobrist_hash(first, false), zobrist_hash(second, false));
+    GTEST_ASSERT_NE(zobrist_hash(first, false), zobrist_hash(start, false));
+}
+
+TEST(zobrist, polyglot_keys)
+{
+    // the test positions published with the Polyglot book format
+    const std::pair<const char*, uint64_t> positions[] {
+        {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 0x463b96181691fc9c},
+        {"rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3 0 1", 0x823c9b50fd114196},
+        {"rnbqkbnr/ppp1pppp/8/3p4/4P3/8/PPPP1PPP/RNBQKBNR w KQkq d6 0 2", 0x0756b94461c50fb0},
+        {"rnbqkbnr/ppp1pppp/8/3pP3/8/8/PPPP1PPP/RNBQKBNR b KQkq - 0 2", 0x662fafb965db29d4},
+        {"rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3", 0x22a48b5a8e47ff78},
+        {"rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPPKPPP/RNBQ1BNR b kq - 0 3", 0x652a607ca3f242c1},
+        {"rnbq1bnr/ppp1pkpp/8/3pPp2/8/8/PPPPKPPP/RNBQ1BNR w - - 0 4", 0x00fdd303c946bdd9},
+        {"rnbqkbnr/p1pppppp/8/8/PpP4P/8/1P1PPPP1/RNBQKBNR b KQkq c3 0 3", 0x3c8123ea7b067637},
+        {"rnbqkbnr/p1pppppp/8/8/P6P/R1p5/1P1PPPP1/1NBQKBNR b Kkq - 0 4", 0x5c3f9b829b279560},
+    };
+    for(auto& [fen, key] : positions){
+        bitboard_frame frame;
+        position_state state;
+        GTEST_ASSERT_EQ(parse_fen(fen, frame, state), true);
+        GTEST_ASSERT_EQ(zobrist_hash(frame, state), key) << fen;
+    }
+}
+
+TEST(book, move_encoding)
+{
+    bitboard_frame start;
+    auto e2e4 {encode_book_move(12, 28, NO_PIECE_OFFSET)};
+    GTEST_ASSERT_EQ(e2e4, 12<<6 | 28);
+    auto decoded {decode_book_move(e2e4, start, PLAYER_OFFSET)};
+    GTEST_ASSERT_EQ(decoded.from_position, 12);
+    GTEST_ASSERT_EQ(decoded.to_position, 28);
+    GTEST_ASSERT_EQ(decoded.promotion_offset, NO_PIECE_OFFSET);
+
+    // castling is stored king-takes-rook and comes back as the two-file king move
+    auto castle {encode_book_move(4, 6, NO_PIECE_OFFSET, true)};
+    GTEST_ASSERT_EQ(castle & 0x3F, 7);
+    decoded = decode_book_move(castle, start, PLAYER_OFFSET);
+    GTEST_ASSERT_EQ(decoded.to_position, 6);
+
+    auto promotion {encode_book_move(52, 60, QUEEN_OFFSET)};
+    GTEST_ASSERT_EQ(decode_book_move(promotion, start, PLAYER_OFFSET).promotion_offset, QUEEN_OFFSET);
+}
+
+TEST(book, build_probe_pick)
+{
+    std::istringstream games{
+        "1. e2e4 e7e5 2. g1f3 b8c6 1-0\n"
+        "1. e2e4 c7c5 2. g1f3 d7d6\n"
+        "1. e2e4 e7e5 2. f2f4\n"
+        "1. d2d4 d7d5\n"
+        "not a game\n"};
+    book_builder builder(4);
+    GTEST_ASSERT_EQ(builder.add_games(games), 4);
+
+    auto path {testing::TempDir() + "test_book.bin"};
+    GTEST_ASSERT_EQ(builder.write(path.c_str()), true);
+
+    opening_book book;
+    GTEST_ASSERT_EQ(book.open(path.c_str()), true);
+    GTEST_ASSERT_EQ(book.entry_count, builder.counts.size());
+    for(size_t i=1; i<book.entry_count; ++i){
+        GTEST_ASSERT_LE(book.key_at(i-1), book.key_at(i));
+    }
+
+    bitboard_frame start;
+    position_state white;
+    position_state black {false};
+    uint16_t moves[8];
+    uint16_t weights[8];
+    auto found {book.probe(zobrist_hash(start, white), moves, weights, 8)};
+    GTEST_ASSERT_EQ(found, 2);
+    for(size_t i=0; i<found; ++i){
+        if(moves[i] == encode_book_move(12, 28, NO_PIECE_OFFSET)){
+            GTEST_ASSERT_EQ(weights[i], 3);
+        }
+        else{
+            GTEST_ASSERT_EQ(moves[i], encode_book_move(11, 27, NO_PIECE_OFFSET));
+            GTEST_ASSERT_EQ(weights[i], 1);
+        }
+    }
+    GTEST_ASSERT_EQ(book.probe(zobrist_hash(start, black), moves, weights, 8), 0);
+
+    std::mt19937_64 rng{7};
+    size_t e4_picks{0};
+    for(int i=0; i<400; ++i){
+        book_move chosen;
+        GTEST_ASSERT_EQ(book.pick(start, white, rng, chosen), true);
+        if(chosen.to_position == 28){
+            ++e4_picks;
+        }
+    }
+    GTEST_ASSERT_GT(e4_picks, 250);
+    GTEST_ASSERT_LT(e4_picks, 350);
+
+    auto after_e4 {start};
+    auto after_e4_state {white};
+    make_move(after_e4, after_e4_state, frame_move{12, 28, PAWN_OFFSET, NO_PIECE_OFFSET, false});
+    book_move reply;
+    GTEST_ASSERT_EQ(book.pick(after_e4, after_e4_state, rng, reply), true);
+    GTEST_ASSERT_EQ(reply.from_position == 52 || reply.from_position == 50, true);
+
+    book.close();
+    std::remove(path.c_str());
+}
@@ -0,0 +1,52 @@
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+#include "bitboard.h"
+#include "engine_stats.h"
+
+TEST(engine_stats, counts_generation)
+{
+    GTEST_ASSERT_EQ(engine_stats_enabled(), true);
+    reset_engine_stats();
+
+    bitboard_frame frm;
+    auto moves {frm.get_next_boards()};
+    auto opponent_moves {frm.get_opponent_next_boards()};
+
+    auto stats {aggregate_engine_stats()};
+    GTEST_ASSERT_EQ(stats.generation_calls, 2);
+    GTEST_ASSERT_EQ(stats.generated_boards, moves.size()+opponent_moves.size());
+    GTEST_ASSERT_EQ(stats.branching_factor(), (moves.size()+opponent_moves.size())/2.0);
+    GTEST_ASSERT_EQ(stats.nodes, 0);
+}
+
+TEST(engine_stats, aggregates_threads)
+{
+    reset_engine_stats();
+    std::vector<std::thread> workers;
+    for(int t=0; t<4; ++t){
+        workers.emplace_back([](){
+            bitboard_frame frm;
+            frame_arena arena;
+            for(int i=0; i<10; ++i){
+                arena_scope scope{arena};
+                frm.get_next_boards(arena);
+                STATS_INC(nodes);
+                STATS_CUTOFF(i);
+            }
+        });
+    }
+    // live counters are readable while the workers run
+    aggregate_engine_stats();
+    for(auto& worker : workers){
+        worker.join();
+    }
+
+    // exited threads are folded into the retired totals
+    auto stats {aggregate_engine_stats()};
+    GTEST_ASSERT_EQ(stats.generation_calls, 40);
+    GTEST_ASSERT_EQ(stats.nodes, 40);
+    GTEST_ASSERT_EQ(stats.cutoffs[0], 4);
+    GTEST_ASSERT_EQ(stats.cutoffs[STATS_CUTOFF_SLOTS-1], 4*(10-(STATS_CUTOFF_SLOTS-1)));
+    GTEST_ASSERT_EQ(stats.first_move_cutoff_rate(), 0.1);
+}
@@ -0,0 +1,144 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <set>
+#include "bitboard.h"
+
+namespace{
+std::atomic<size_t> heap_allocations{0};
+}
+
+// Counts global-heap allocations so the arena path can be checked for none.
+// The replacement covers the whole test binary, threaded tests included.
+void* operator new(size_t bytes){
+    heap_allocations.fetch_add(1, std::memory_order_relaxed);
+    if(auto p = std::malloc(bytes ? bytes : 1)){
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept{
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept{
+    std::free(p);
+}
+
+std::set<std::pair<uint64_t,uint64_t>> board_keys(const bitboard_frame* begin, const bitboard_frame* end){
+    std::set<std::pair<uint64_t,uint64_t>> keys;
+    for(auto b=begin; b!=end; ++b){
+        keys.emplace(b->player.pieces[PAWN_OFFSET] ^ b->player.pieces[ROOK_OFFSET]<<1, b->opponent.pieces[PAWN_OFFSET] ^ b->opponent.pieces[ROOK_OFFSET]<<1);
+    }
+    return keys;
+}
+
+TEST(frame_arena, allocate_mark_release)
+{
+    frame_arena arena(1024);
+    auto a {arena.allocate<uint64_t>(4)};
+    GTEST_ASSERT_EQ(reinterpret_cast<uintptr_t>(a)%alignof(uint64_t), 0);
+    GTEST_ASSERT_EQ(arena.mark(), 32);
+
+    {
+        arena_scope scope{arena};
+        arena.allocate<uint64_t>(64);
+        GTEST_ASSERT_EQ(arena.mark(), 32+512);
+    }
+    GTEST_ASSERT_EQ(arena.mark(), 32);
+    GTEST_ASSERT_EQ(arena.peak_usage(), 32+512);
+
+    arena.reset();
+    GTEST_ASSERT_EQ(arena.mark(), 0);
+    GTEST_ASSERT_EQ(arena.peak_usage(), 32+512);
+
+    bool threw{false};
+    try{
+        arena.allocate<uint64_t>(512);
+    }
+    catch(const std::bad_alloc&){
+        threw = true;
+    }
+    GTEST_ASSERT_EQ(threw, true);
+}
+
+TEST(frame_arena, matches_vector_successors)
+{
+    bitboard_frame frm;
+    frm.set_pieces(PLAYER_OFFSET, ROOK_OFFSET, (uint64_t)1<<26 | (uint64_t)1<<29);
+
+    frame_arena arena;
+    auto expected {frm.get_next_boards()};
+    auto next {frm.get_next_boards(arena)};
+    GTEST_ASSERT_EQ(next.size(), expected.size());
+    GTEST_ASSERT_EQ(board_keys(next.begin(), next.end()), board_keys(expected.data(), expected.data()+expected.size()));
+    // the unused tail of the run is handed back
+    GTEST_ASSERT_EQ(arena.mark(), sizeof(bitboard_frame)*next.size());
+
+    auto expected_opponent {frm.get_opponent_next_boards()};
+    auto next_opponent {frm.get_opponent_next_boards(arena)};
+    GTEST_ASSERT_EQ(next_opponent.size(), expected_opponent.size());
+    GTEST_ASSERT_EQ(next_opponent.begin(), next.end());
+}
+
+TEST(frame_arena, list_grows_past_capacity)
+{
+    frame_arena arena(4096);
+    arena_list<uint64_t> grown{arena, 4};
+    for(uint64_t i=0; i<10; ++i){
+        grown.emplace_back(i);
+    }
+    // nothing followed the run, so it grew in place
+    GTEST_ASSERT_EQ(arena.mark(), sizeof(uint64_t)*16);
+
+    arena_list<uint64_t> moved{arena, 2};
+    moved.emplace_back(100);
+    moved.emplace_back(101);
+    auto after {arena.allocate<uint64_t>(1)};
+    *after = 7;
+    moved.emplace_back(102);
+    GTEST_ASSERT_EQ(*after, 7);
+
+    auto span {moved.finish()};
+    GTEST_ASSERT_EQ(span.size(), 3);
+    for(uint64_t i=0; i<3; ++i){
+        GTEST_ASSERT_EQ(span[i], 100+i);
+    }
+    for(uint64_t i=0; i<10; ++i){
+        GTEST_ASSERT_EQ(grown.data[i], i);
+    }
+}
+
+size_t walk(bitboard_frame& frame, frame_arena& arena, size_t depth, bool player_to_move){
+    if(depth == 0){
+        return 1;
+    }
+    arena_scope scope{arena};
+    auto next {player_to_move? frame.get_next_boards(arena) : frame.get_opponent_next_boards(arena)};
+    size_t nodes{0};
+    for(auto& child : next){
+        nodes += walk(child, arena, depth-1, !player_to_move);
+    }
+    return nodes;
+}
+
+TEST(frame_arena, no_heap_in_steady_state)
+{
+    bitboard_frame frm;
+    frame_arena arena;
+
+    auto first {walk(frm, arena, 3, true)};
+    GTEST_ASSERT_EQ(arena.mark(), 0);
+    auto peak {arena.peak_usage()};
+    GTEST_ASSERT_GT(peak, 0);
+
+    auto before {heap_allocations.load(std::memory_order_relaxed)};
+    for(int iteration=0; iteration<3; ++iteration){
+        arena.reset();
+        GTEST_ASSERT_EQ(walk(frm, arena, 3, true), first);
+    }
+    GTEST_ASSERT_EQ(heap_allocations.load(std::memory_order_relaxed), before);
+    GTEST_ASSERT_EQ(arena.peak_usage(), peak);
+}
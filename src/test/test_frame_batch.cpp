@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <array>
+#include <random>
+#include <set>
+#include <vector>
+#include "frame_batch.h"
+
+std::array<uint64_t,12> frame_boards(const bitboard_frame& frame){
+    std::array<uint64_t,12> boards;
+    std::copy(&frame.side(0).pieces[0], &frame.side(0).pieces[0]+12, boards.begin());
+    return boards;
+}
+
+std::multiset<std::array<uint64_t,12>> frame_set(const bitboard_frame* begin, const bitboard_frame* end){
+    std::multiset<std::array<uint64_t,12>> boards;
+    for(auto frame=begin; frame!=end; ++frame){
+        boards.insert(frame_boards(*frame));
+    }
+    return boards;
+}
+
+std::vector<bitboard_frame> random_positions(size_t count, bool player_to_move){
+    std::mt19937_64 rng{11};
+    std::vector<bitboard_frame> positions;
+    auto frame {bitboard_frame::empty()};
+    frame.set_pieces(PLAYER_OFFSET, PAWN_OFFSET, start_pawns(1));
+    frame.set_pieces(PLAYER_OFFSET, ROOK_OFFSET, start_rook(0));
+    frame.set_pieces(OPPONENT_OFFSET, PAWN_OFFSET, start_pawns(6));
+    frame.set_pieces(OPPONENT_OFFSET, ROOK_OFFSET, start_rook(7));
+    auto side {true};
+    while(positions.size() < count){
+        if(side == player_to_move){
+            positions.push_back(frame);
+        }
+        auto next {side? frame.get_next_boards() : frame.get_opponent_next_boards()};
+        if(next.empty()){
+            break;
+        }
+        frame = next[rng()%next.size()];
+        side = !side;
+    }
+    return positions;
+}
+
+TEST(frame_batch, matches_scalar_generation)
+{
+    for(auto player_to_move : {true, false}){
+        auto positions {random_positions(37, player_to_move)};
+        frame_batch batch;
+        for(auto& frame : positions){
+            batch.push_back(frame);
+        }
+        GTEST_ASSERT_EQ(batch.size(), positions.size());
+        GTEST_ASSERT_EQ(frame_boards(batch.frame_at(5)), frame_boards(positions[5]));
+
+        successor_batch out;
+        get_next_boards_batch(batch, player_to_move, out);
+        GTEST_ASSERT_EQ(out.offsets.size(), positions.size()+1);
+        GTEST_ASSERT_EQ(out.offsets.back(), out.boards.size());
+        for(size_t i=0; i<positions.size(); ++i){
+            auto expected {player_to_move? positions[i].get_next_boards() : positions[i].get_opponent_next_boards()};
+            GTEST_ASSERT_EQ(out.count(i), expected.size());
+            GTEST_ASSERT_EQ(frame_set(out.begin(i), out.end(i)), frame_set(expected.data(), expected.data()+expected.size()));
+        }
+    }
+}
+
+TEST(frame_batch, reuses_output)
+{
+    auto positions {random_positions(8, true)};
+    frame_batch batch;
+    for(auto& frame : positions){
+        batch.push_back(frame);
+    }
+    successor_batch out;
+    get_next_boards_batch(batch, true, out);
+    auto first_count {out.boards.size()};
+    auto storage {out.boards.data()};
+    get_next_boards_batch(batch, true, out);
+    GTEST_ASSERT_EQ(out.boards.size(), first_count);
+    GTEST_ASSERT_EQ(out.boards.data(), storage);
+
+    batch.clear();
+    GTEST_ASSERT_EQ(batch.size(), 0);
+    get_next_boards_batch(batch, true, out);
+    GTEST_ASSERT_EQ(out.boards.size(), 0);
+    GTEST_ASSERT_EQ(out.offsets.size(), 1);
+}
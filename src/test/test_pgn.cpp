@@ -0,0 +1,165 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <string>
+#include <vector>
+#include "notation.h"
+#include "pgn.h"
+
+namespace{
+const char* KIWIPETE = "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1";
+
+const char* GAMES =
+    "[Event \"first\"]\n"
+    "[Result \"1-0\"]\n"
+    "\n"
+    "1. e4 e5 2. Nf3 Nc6 3. Bb5 {Ruy Lopez\n"
+    "[not a tag] still a comment} a6 4. Ba4 Nf6 5. O-O Be7 (5... b5 6. Bb3) 6. Re1 b5\n"
+    "7. Bb3 d6 8. c3 O-O $1 9. h3 1-0\n"
+    "\n"
+    "[Event \"en passant and promotion\"]\n"
+    "[Result \"*\"]\n"
+    "\n"
+    "1.e4 Nf6 2.e5 d5 3.exd6 e5 4.dxc7 Qe7+ 5.cxb8=Q Rxb8 *\n"
+    "[Event \"from a position\"]\n"
+    "[FEN \"4k3/8/8/8/8/8/8/R3K2R w KQ - 0 1\"]\n"
+    "[SetUp \"1\"]\n"
+    "\n"
+    "1. 0-0-0 Kf7 2. Rh7+ Kg6 3. Qd4 ; no queen there\n"
+    "*\n";
+
+position_state start_state(const char* fen, bitboard_frame& frame){
+    position_state state;
+    EXPECT_EQ(parse_fen(fen, frame, state), true);
+    return state;
+}
+}
+
+TEST(movegen, perft)
+{
+    bitboard_frame frame;
+    auto state {start_state(START_FEN, frame)};
+    GTEST_ASSERT_EQ(perft(frame, state, 1), 20);
+    GTEST_ASSERT_EQ(perft(frame, state, 3), 8902);
+
+    // castling, pins and promotions
+    state = start_state(KIWIPETE, frame);
+    GTEST_ASSERT_EQ(perft(frame, state, 1), 48);
+    GTEST_ASSERT_EQ(perft(frame, state, 3), 97862);
+
+    // en passant that would expose the king
+    state = start_state("8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", frame);
+    GTEST_ASSERT_EQ(perft(frame, state, 4), 43238);
+
+    state = start_state("r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", frame);
+    GTEST_ASSERT_EQ(perft(frame, state, 3), 9467);
+}
+
+TEST(movegen, fen_state_round_trip)
+{
+    bitboard_frame frame;
+    auto state {start_state("rnbqkbnr/ppp1pppp/8/3pP3/8/8/PPPP1PPP/RNBQKBNR w Kq d6 0 1", frame)};
+    GTEST_ASSERT_EQ(state.castling, CASTLE_WHITE_KING | CASTLE_BLACK_QUEEN);
+    GTEST_ASSERT_EQ(state.en_passant, compute_distance(5, 3));
+    GTEST_ASSERT_EQ(to_fen(frame, state), "rnbqkbnr/ppp1pppp/8/3pP3/8/8/PPPP1PPP/RNBQKBNR w Kq d6 0 1");
+    GTEST_ASSERT_EQ(parse_fen("8/8/8/8/8/8/8/4K2k w X - 0 1", frame, state), false);
+}
+
+TEST(movegen, resolve_san)
+{
+    bitboard_frame frame;
+    frame_move moves[MAX_MOVES];
+    frame_move move;
+
+    // the c3 knight is pinned, so Ne2 needs no disambiguation
+    auto state {start_state("4k3/8/8/b7/8/2N5/8/4K1N1 w - - 0 1", frame)};
+    auto count {generate_moves(frame, state, moves)};
+    GTEST_ASSERT_EQ(resolve_san(frame, state, "Ne2", moves, count, move), true);
+    GTEST_ASSERT_EQ(coordinate_move(move), "g1e2");
+    GTEST_ASSERT_EQ(resolve_san(frame, state, "Nce2", moves, count, move), false);
+
+    state = start_state("4k3/8/8/8/8/8/8/2N1K1N1 w - - 0 1", frame);
+    count = generate_moves(frame, state, moves);
+    GTEST_ASSERT_EQ(resolve_san(frame, state, "Ne2", moves, count, move), false);
+    GTEST_ASSERT_EQ(resolve_san(frame, state, "Nge2+", moves, count, move), true);
+    GTEST_ASSERT_EQ(coordinate_move(move), "g1e2");
+
+    state = start_state("4k3/1P6/8/8/8/8/8/4K2R w K - 0 1", frame);
+    count = generate_moves(frame, state, moves);
+    GTEST_ASSERT_EQ(resolve_san(frame, state, "b8=N", moves, count, move), true);
+    GTEST_ASSERT_EQ(move.promotion_offset, KNIGHT_OFFSET);
+    GTEST_ASSERT_EQ(resolve_san(frame, state, "b8Q!", moves, count, move), true);
+    GTEST_ASSERT_EQ(move.promotion_offset, QUEEN_OFFSET);
+    GTEST_ASSERT_EQ(resolve_san(frame, state, "b8", moves, count, move), false);
+    GTEST_ASSERT_EQ(resolve_san(frame, state, "O-O", moves, count, move), true);
+    GTEST_ASSERT_EQ(coordinate_move(move), "e1g1");
+}
+
+TEST(pgn, split_and_replay)
+{
+    std::string archive {GAMES};
+    std::vector<pgn_game_text> games;
+    GTEST_ASSERT_EQ(split_pgn_games(archive.data(), archive.size(), [&](const pgn_game_text& game){ games.push_back(game); }), 3);
+    GTEST_ASSERT_EQ(std::string(games[1].text, 34), "[Event \"en passant and promotion\"]");
+
+    std::string last_fen;
+    pgn_callbacks callbacks;
+    callbacks.on_move = [&](size_t, const pgn_game_info&, const pgn_ply& ply){
+        auto next {ply.frame};
+        auto state {ply.state};
+        make_move(next, state, ply.move);
+        last_fen = to_fen(next, state);
+    };
+
+    auto info {replay_pgn_game(games[0], 0, callbacks)};
+    GTEST_ASSERT_EQ(info.complete, true);
+    GTEST_ASSERT_EQ(info.plies, 17);
+    GTEST_ASSERT_EQ(info.result, "1-0");
+    GTEST_ASSERT_EQ(last_fen, "r1bq1rk1/2p1bppp/p1np1n2/1p2p3/4P3/1BP2N1P/PP1P1PP1/RNBQR1K1 b - - 0 1");
+
+    info = replay_pgn_game(games[1], 0, callbacks);
+    GTEST_ASSERT_EQ(info.complete, true);
+    GTEST_ASSERT_EQ(info.plies, 10);
+    GTEST_ASSERT_EQ(last_fen, "1rb1kb1r/pp2qppp/5n2/4p3/8/8/PPPP1PPP/RNBQKBNR w KQk - 0 1");
+
+    info = replay_pgn_game(games[2], 0, callbacks);
+    GTEST_ASSERT_EQ(info.complete, false);
+    GTEST_ASSERT_EQ(info.plies, 4);
+    GTEST_ASSERT_EQ(info.failed_token, "Qd4");
+    GTEST_ASSERT_EQ(info.fen, "4k3/8/8/8/8/8/8/R3K2R w KQ - 0 1");
+}
+
+TEST(pgn, parallel_replay)
+{
+    std::string archive;
+    for(int i=0; i<50; ++i){
+        archive += GAMES;
+        archive += "\n";
+    }
+    std::atomic<uint64_t> moves{0};
+    std::atomic<uint64_t> finished{0};
+    pgn_callbacks callbacks;
+    callbacks.on_move = [&](size_t worker, const pgn_game_info&, const pgn_ply&){
+        EXPECT_LT(worker, 4);
+        ++moves;
+    };
+    callbacks.on_game = [&](size_t, const pgn_game_info&){ ++finished; };
+    auto stats {replay_pgn(archive.data(), archive.size(), 4, callbacks)};
+    GTEST_ASSERT_EQ(stats.games, 150);
+    GTEST_ASSERT_EQ(stats.failed_games, 50);
+    GTEST_ASSERT_EQ(stats.plies, 50*(17+10+4));
+    GTEST_ASSERT_EQ(moves, stats.plies);
+    GTEST_ASSERT_EQ(finished, 150);
+
+    auto path {testing::TempDir() + "test_games.pgn"};
+    {
+        std::FILE* out {std::fopen(path.c_str(), "wb")};
+        std::fwrite(archive.data(), 1, archive.size(), out);
+        std::fclose(out);
+    }
+    pgn_archive mapped;
+    GTEST_ASSERT_EQ(mapped.open(path.c_str()), true);
+    GTEST_ASSERT_EQ(mapped.size, archive.size());
+    GTEST_ASSERT_EQ(replay_pgn(mapped.data, mapped.size, 2, pgn_callbacks{}).plies, stats.plies);
+    mapped.close();
+    std::remove(path.c_str());
+}
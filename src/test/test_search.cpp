@@ -0,0 +1,269 @@
+#include <gtest/gtest.h>
+#include <set>
+#include "match.h"
+#include "notation.h"
+#include "search.h"
+#include "zobrist.h"
+
+bitboard_frame frame_from_fen(const char* fen, bool& player_to_move){
+    bitboard_frame frame;
+    EXPECT_EQ(parse_fen(fen, frame, player_to_move), true);
+    return frame;
+}
+
+bitboard_frame frame_from_fen(const char* fen, position_state& state){
+    bitboard_frame frame;
+    EXPECT_EQ(parse_fen(fen, frame, state), true);
+    return frame;
+}
+
+std::set<std::string> legal_sans(const bitboard_frame& frame, const position_state& state){
+    frame_move moves[MAX_MOVES];
+    auto count {generate_moves(frame, state, moves)};
+    std::set<std::string> sans;
+    for(size_t i=0; i<count; ++i){
+        if(is_legal(frame, state, moves[i])){
+            sans.insert(san_move(frame, state, moves[i], moves, count));
+        }
+    }
+    return sans;
+}
+
+TEST(notation, fen_round_trip)
+{
+    bool player_to_move;
+    auto start {frame_from_fen(START_FEN, player_to_move)};
+    GTEST_ASSERT_EQ(player_to_move, true);
+    bitboard_frame expected;
+    GTEST_ASSERT_EQ(zobrist_hash(start, true), zobrist_hash(expected, true));
+    GTEST_ASSERT_EQ(to_fen(start, true), "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w - - 0 1");
+
+    auto fen {"4k3/8/8/3p4/8/8/8/R3K2R b - - 0 1"};
+    auto frame {frame_from_fen(fen, player_to_move)};
+    GTEST_ASSERT_EQ(player_to_move, false);
+    GTEST_ASSERT_EQ(to_fen(frame, false), fen);
+
+    bitboard_frame unused{frame};
+    GTEST_ASSERT_EQ(parse_fen("8/8/8 w", unused, player_to_move), false);
+    GTEST_ASSERT_EQ(parse_fen("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNX w", unused, player_to_move), false);
+}
+
+TEST(notation, san_disambiguation)
+{
+    bool player_to_move;
+    auto frame {frame_from_fen("4k3/8/8/3p4/8/8/7K/R6R w - - 0 1", player_to_move)};
+    auto next {frame.get_next_boards()};
+    std::set<std::string> sans;
+    for(auto& child : next){
+        sans.insert(san_move(frame, child, true, next.data(), next.size()));
+    }
+    GTEST_ASSERT_EQ(sans.count("Rab1"), 1);
+    GTEST_ASSERT_EQ(sans.count("Rhb1"), 1);
+    GTEST_ASSERT_EQ(sans.count("Rb1"), 0);
+    GTEST_ASSERT_EQ(sans.count("Ra8"), 1);
+    GTEST_ASSERT_EQ(sans.count("Rh2"), 0);
+
+    frame = frame_from_fen("4k3/8/8/3p4/8/R7/7K/R7 w - - 0 1", player_to_move);
+    next = frame.get_next_boards();
+    sans.clear();
+    for(auto& child : next){
+        sans.insert(san_move(frame, child, true, next.data(), next.size()));
+    }
+    GTEST_ASSERT_EQ(sans.count("R1a2"), 1);
+    GTEST_ASSERT_EQ(sans.count("R3a2"), 1);
+    GTEST_ASSERT_EQ(sans.count("Rb3"), 1);
+
+    frame = frame_from_fen("4k3/8/8/3p4/4P3/8/8/4K3 w - - 0 1", player_to_move);
+    next = frame.get_next_boards();
+    sans.clear();
+    for(auto& child : next){
+        sans.insert(san_move(frame, child, true, next.data(), next.size()));
+    }
+    GTEST_ASSERT_EQ(sans, (std::set<std::string>{"e5", "exd5"}));
+}
+
+TEST(notation, san_check_marks)
+{
+    position_state state;
+    auto frame {frame_from_fen("6k1/5ppp/8/8/8/8/8/R5K1 w - - 0 1", state)};
+    auto sans {legal_sans(frame, state)};
+    GTEST_ASSERT_EQ(sans.count("Ra8#"), 1);
+    GTEST_ASSERT_EQ(sans.count("Ra7"), 1);
+
+    frame = frame_from_fen("4k3/8/8/8/8/8/8/R5K1 w - - 0 1", state);
+    sans = legal_sans(frame, state);
+    GTEST_ASSERT_EQ(sans.count("Ra8+"), 1);
+    GTEST_ASSERT_EQ(sans.count("Kf1"), 1);
+
+    // moves into check are not listed
+    frame = frame_from_fen("4k3/8/8/8/8/8/5r2/R5K1 w - - 0 1", state);
+    sans = legal_sans(frame, state);
+    GTEST_ASSERT_EQ(sans.count("Kf1"), 0);
+    GTEST_ASSERT_EQ(sans.count("Kxf2"), 1);
+}
+
+TEST(transposition, store_probe_replace)
+{
+    transposition_table table{1};
+    tt_data found;
+    GTEST_ASSERT_EQ(table.probe(12345, found), false);
+
+    table.store(12345, {-42, 3, TT_BOUND_LOWER, 7});
+    GTEST_ASSERT_EQ(table.probe(12345, found), true);
+    GTEST_ASSERT_EQ(found.score, -42);
+    GTEST_ASSERT_EQ(found.depth, 3);
+    GTEST_ASSERT_EQ(found.bound, TT_BOUND_LOWER);
+    GTEST_ASSERT_EQ(found.best_index, 7);
+    GTEST_ASSERT_EQ(table.probe(12345 + table.size(), found), false);
+
+    // shallower results for the same key keep the deeper entry
+    table.store(12345, {5, 1, TT_BOUND_EXACT, 1});
+    table.probe(12345, found);
+    GTEST_ASSERT_EQ(found.depth, 3);
+
+    // move lists run past 255 entries, so indices are not truncated
+    table.store(999, {1, 2, TT_BOUND_UPPER, 255});
+    table.probe(999, found);
+    GTEST_ASSERT_EQ(found.best_index, 255);
+    GTEST_ASSERT_NE(found.best_index, TT_NO_MOVE);
+    table.store(1000, {1, 2, TT_BOUND_EXACT, 300});
+    table.probe(1000, found);
+    GTEST_ASSERT_EQ(found.best_index, 300);
+    GTEST_ASSERT_EQ(found.bound, TT_BOUND_EXACT);
+
+    table.clear();
+    GTEST_ASSERT_EQ(table.probe(12345, found), false);
+}
+
+TEST(search, wins_material_and_mates)
+{
+    transposition_table table{1};
+    frame_arena arena;
+    searcher search{table, arena};
+    position_state state;
+
+    // the rook on a1 can take the undefended rook on a7
+    auto frame {frame_from_fen("6k1/r6p/8/8/8/8/5PPP/R5K1 w - - 0 1", state)};
+    auto result {search.search(frame, state, search_limits{3, 0})};
+    GTEST_ASSERT_EQ(result.found, true);
+    GTEST_ASSERT_EQ(coordinate_move(result.move), "a1a7");
+    GTEST_ASSERT_EQ(result.move.capture, true);
+    GTEST_ASSERT_GT(result.score, 300);
+    GTEST_ASSERT_EQ(arena.mark(), 0);
+
+    // back rank mate in one
+    frame = frame_from_fen("6k1/5ppp/8/8/8/8/8/R5K1 w - - 0 1", state);
+    table.clear();
+    result = search.search(frame, state, search_limits{4, 0});
+    GTEST_ASSERT_EQ(coordinate_move(result.move), "a1a8");
+    GTEST_ASSERT_EQ(result.score, MATE_SCORE-1);
+
+    // the side to move is mated or stalemated, there is nothing to search
+    frame = frame_from_fen("R5k1/5ppp/8/8/8/8/8/6K1 b - - 0 1", state);
+    GTEST_ASSERT_EQ(search.search(frame, state, search_limits{3, 0}).found, false);
+    GTEST_ASSERT_EQ(search.negamax(frame, state, attack_map{frame}, 2, -MATE_SCORE, MATE_SCORE, 0), -MATE_SCORE);
+    frame = frame_from_fen("7k/5Q2/6K1/8/8/8/8/8 b - - 0 1", state);
+    GTEST_ASSERT_EQ(search.negamax(frame, state, attack_map{frame}, 2, -MATE_SCORE, MATE_SCORE, 0), 0);
+
+    // a node limit still returns a move from the first iteration
+    table.clear();
+    frame = frame_from_fen(START_FEN, state);
+    result = search.search(frame, state, search_limits{MAX_SEARCH_DEPTH, 50});
+    GTEST_ASSERT_EQ(result.found, true);
+    GTEST_ASSERT_GE(result.depth, 1);
+}
+
+TEST(match, game_terminates_with_pgn)
+{
+    engine_config engine;
+    engine.limits.depth = 2;
+    engine.hash_mb = 1;
+    adjudication_rules rules;
+    rules.max_plies = 40;
+    position_state state;
+    auto frame {frame_from_fen(START_FEN, state)};
+    auto game {play_game(frame, state, engine, engine, rules)};
+    GTEST_ASSERT_LE(game.moves.size(), 40);
+    GTEST_ASSERT_EQ(game.moves.size(), game.scores.size());
+    GTEST_ASSERT_EQ(game.moves.size(), game.states.size());
+    GTEST_ASSERT_EQ(game.termination.empty(), false);
+
+    auto pgn {to_pgn(game, "test", 1)};
+    GTEST_ASSERT_NE(pgn.find("[Result \"" + std::string(result_text(game.result)) + "\"]"), std::string::npos);
+    GTEST_ASSERT_NE(pgn.find("1. " + game.moves[0]), std::string::npos);
+    GTEST_ASSERT_EQ(pgn.find("[FEN"), std::string::npos);
+
+    engine_config parsed;
+    GTEST_ASSERT_EQ(parse_engine_config("name=new,depth=5,nodes=1000,rook=520", parsed), true);
+    GTEST_ASSERT_EQ(parsed.name, "new");
+    GTEST_ASSERT_EQ(parsed.limits.depth, 5);
+    GTEST_ASSERT_EQ(parsed.limits.nodes, 1000);
+    GTEST_ASSERT_EQ(parsed.weights.piece_values[ROOK_OFFSET], 520);
+    GTEST_ASSERT_EQ(parse_engine_config("speed=9", parsed), false);
+}
+
+TEST(match, games_end_by_the_rules)
+{
+    engine_config engine;
+    engine.limits.depth = 2;
+    engine.hash_mb = 1;
+    adjudication_rules rules;
+    position_state state;
+
+    auto frame {frame_from_fen("6k1/5ppp/8/8/8/8/8/R5K1 w - - 0 1", state)};
+    auto game {play_game(frame, state, engine, engine, rules)};
+    GTEST_ASSERT_EQ(game.moves, (std::vector<std::string>{"Ra8#"}));
+    GTEST_ASSERT_EQ(game.result, GAME_WHITE_WIN);
+    GTEST_ASSERT_EQ(game.termination, "checkmate");
+    GTEST_ASSERT_NE(to_pgn(game, "test", 1).find("[FEN \"6k1/5ppp/8/8/8/8/8/R5K1 w - - 0 1\"]"), std::string::npos);
+
+    frame = frame_from_fen("7k/5Q2/6K1/8/8/8/8/8 b - - 0 1", state);
+    game = play_game(frame, state, engine, engine, rules);
+    GTEST_ASSERT_EQ(game.moves.empty(), true);
+    GTEST_ASSERT_EQ(game.result, GAME_DRAW);
+    GTEST_ASSERT_EQ(game.termination, "stalemate");
+
+    frame = frame_from_fen("8/8/4k3/8/8/3NK3/8/8 w - - 0 1", state);
+    game = play_game(frame, state, engine, engine, rules);
+    GTEST_ASSERT_EQ(game.termination, "insufficient material");
+
+    // kings and rooks shuffle until a position comes round a third time,
+    // or fifty moves pass without a capture
+    rules.resign_score = MATE_SCORE;
+    rules.draw_plies = 1000;
+    frame = frame_from_fen("r3k3/8/8/8/8/8/8/R3K3 w - - 0 1", state);
+    game = play_game(frame, state, engine, engine, rules);
+    GTEST_ASSERT_EQ(game.result, GAME_DRAW);
+    GTEST_ASSERT_EQ(game.termination == "threefold repetition" || game.termination == "fifty-move rule", true);
+}
+
+TEST(match, sprt_decisions)
+{
+    sprt_test even;
+    for(int i=0; i<30000; ++i){
+        even.add(i%3 - 1);
+    }
+    GTEST_ASSERT_EQ(even.decision(), -1);
+    GTEST_ASSERT_LT(std::abs(even.elo()), 1.0);
+
+    sprt_test stronger;
+    for(int i=0; i<2000; ++i){
+        stronger.add(i%5 == 0? -1 : i%5 == 1? 0 : 1);
+    }
+    GTEST_ASSERT_EQ(stronger.decision(), 1);
+    GTEST_ASSERT_GT(stronger.elo(), 100);
+
+    sprt_test early;
+    early.add(1);
+    early.add(-1);
+    GTEST_ASSERT_EQ(early.decision(), 0);
+
+    // the mean and variance both come from the regularized frequencies,
+    // (5.5, 0.5, 0.5) over 6.5 games here
+    sprt_test lopsided;
+    for(int i=0; i<5; ++i){
+        lopsided.add(1);
+    }
+    GTEST_ASSERT_LT(std::abs(lopsided.llr() - 0.16547), 1e-4);
+    GTEST_ASSERT_EQ(lopsided.decision(), 0);
+}
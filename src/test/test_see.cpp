@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+#include "attacks.h"
+#include "notation.h"
+#include "search.h"
+#include "see.h"
+
+namespace{
+bitboard_frame see_frame(const char* fen){
+    bitboard_frame frame;
+    bool player_to_move;
+    EXPECT_EQ(parse_fen(fen, frame, player_to_move), true);
+    return frame;
+}
+
+size_t square(const char* name){
+    return compute_distance(name[1]-'1', name[0]-'a');
+}
+}
+
+TEST(attacks, piece_patterns)
+{
+    GTEST_ASSERT_EQ(knight_attacks((uint64_t)1<<square("a1")), (uint64_t)1<<square("b3") | (uint64_t)1<<square("c2"));
+    GTEST_ASSERT_EQ(__builtin_popcountll(knight_attacks((uint64_t)1<<square("e4"))), 8);
+    GTEST_ASSERT_EQ(king_attacks((uint64_t)1<<square("h8")), (uint64_t)1<<square("g8") | (uint64_t)1<<square("g7") | (uint64_t)1<<square("h7"));
+    GTEST_ASSERT_EQ(pawn_attacks(PLAYER_OFFSET, (uint64_t)1<<square("a2")), (uint64_t)1<<square("b3"));
+    GTEST_ASSERT_EQ(pawn_attacks(OPPONENT_OFFSET, (uint64_t)1<<square("a7")), (uint64_t)1<<square("b6"));
+    GTEST_ASSERT_EQ(__builtin_popcountll(bishop_attacks(square("a1"), 0)), 7);
+
+    uint64_t blocker {(uint64_t)1<<square("a4")};
+    auto rook {rook_attacks(square("a1"), blocker)};
+    GTEST_ASSERT_EQ(__builtin_popcountll(rook), 3 + 7);
+    GTEST_ASSERT_GT(rook & blocker, 0);
+
+    auto frame {see_frame("4k3/8/4p3/3p4/8/8/8/3RK3 w - - 0 1")};
+    auto attackers {attackers_to(frame, square("d5"), frame.occupied)};
+    GTEST_ASSERT_EQ(attackers, (uint64_t)1<<square("d1") | (uint64_t)1<<square("e6"));
+}
+
+TEST(see, exchanges)
+{
+    evaluation_weights weights;
+    auto values {weights.piece_values};
+
+    auto frame {see_frame("4k3/8/8/3p4/8/8/8/3RK3 w - - 0 1")};
+    GTEST_ASSERT_EQ(static_exchange(frame, PLAYER_OFFSET, square("d1"), square("d5"), values), 100);
+
+    // the pawn is defended, the rook is lost for it
+    frame = see_frame("4k3/8/4p3/3p4/8/8/8/3RK3 w - - 0 1");
+    GTEST_ASSERT_EQ(static_exchange(frame, PLAYER_OFFSET, square("d1"), square("d5"), values), 100-500);
+
+    // the a1 rook only reaches a7 once the a2 rook has gone, both ways round
+    frame = see_frame("r3k3/r7/8/8/8/8/R7/R3K3 w - - 0 1");
+    GTEST_ASSERT_EQ(static_exchange(frame, PLAYER_OFFSET, square("a2"), square("a7"), values), 500);
+    GTEST_ASSERT_EQ(static_exchange(frame, OPPONENT_OFFSET, square("a7"), square("a2"), values), 500);
+
+    // the recapture only wins back the pawn
+    frame = see_frame("3rk3/8/8/3r4/4P3/8/8/4K3 w - - 0 1");
+    GTEST_ASSERT_EQ(static_exchange(frame, PLAYER_OFFSET, square("e4"), square("d5"), values), 500-100);
+}
+
+TEST(quiescence, resolves_captures_and_prunes)
+{
+    transposition_table table{1};
+    frame_arena arena;
+    searcher search{table, arena};
+
+    // a one ply search no longer grabs a defended pawn
+    position_state state;
+    bitboard_frame frame;
+    parse_fen("4k3/8/4p3/3p4/8/8/7P/3RK3 w - - 0 1", frame, state);
+    auto result {search.search(frame, state, search_limits{1, 0})};
+    GTEST_ASSERT_NE(coordinate_move(result.move), "d1d5");
+    GTEST_ASSERT_GT(result.qnodes, 0);
+    GTEST_ASSERT_EQ(arena.mark(), 0);
+
+    // rooks in among defended pawns, most captures lose the rook
+    parse_fen("4k3/1p1p1p1p/p1p1p1p1/1R1R1R2/2r1r1r1/P1P1P1P1/1P1P1P1P/4K3 w - - 0 1", frame, state);
+    table.clear();
+    auto pruned {search.search(frame, state, search_limits{3, 0})};
+    search.see_pruning = false;
+    table.clear();
+    auto every_capture {search.search(frame, state, search_limits{3, 0})};
+    GTEST_ASSERT_LT(pruned.qnodes, every_capture.qnodes);
+    GTEST_ASSERT_EQ(pruned.score, every_capture.score);
+}
@@ -0,0 +1,211 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <set>
+#include <vector>
+#include "notation.h"
+#include "training.h"
+#include "zobrist.h"
+
+namespace{
+std::vector<training_record> read_records(const std::string& path){
+    std::vector<training_record> records;
+    std::ifstream in(path, std::ios::binary);
+    unsigned char buffer[TRAINING_RECORD_SIZE];
+    while(in.read((char*)buffer, TRAINING_RECORD_SIZE)){
+        records.push_back(decode_training_record(buffer));
+    }
+    return records;
+}
+
+// What the filter should keep of a game, judged with the state each
+// position really had rather than the little a record carries.
+std::vector<training_record> expected_records(const training_options& options, const game_record& game){
+    std::vector<training_record> records;
+    for(size_t ply=0; ply<game.positions.size(); ++ply){
+        auto& state {game.states[ply]};
+        auto score {game.scores[ply]};
+        if(std::abs(score) > options.max_score || !is_quiet_position(game.positions[ply], state)){
+            continue;
+        }
+        training_record record;
+        record.board = compressed_board{game.positions[ply]};
+        record.player_to_move = state.player_to_move;
+        record.score = (int16_t)(state.player_to_move? score : -score);
+        record.result = (int8_t)game.result;
+        records.push_back(record);
+    }
+    return records;
+}
+
+bool same_record(const training_record& a, const training_record& b){
+    return a.board == b.board && a.player_to_move == b.player_to_move && a.score == b.score && a.result == b.result;
+}
+}
+
+TEST(compressed_board, round_trip)
+{
+    bitboard_frame frame;
+    bool player_to_move;
+    GTEST_ASSERT_EQ(parse_fen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R b KQkq - 0 1", frame, player_to_move), true);
+    compressed_board board{frame};
+    GTEST_ASSERT_EQ(board.square(0), ROOK_OFFSET+1);
+    GTEST_ASSERT_EQ(board.square(4), KING_OFFSET+1);
+    GTEST_ASSERT_EQ(board.square(60), KING_OFFSET+9);
+    GTEST_ASSERT_EQ(board.square(32), 0);
+    GTEST_ASSERT_EQ(to_fen(board.to_frame(), player_to_move), to_fen(frame, player_to_move));
+    GTEST_ASSERT_EQ(compressed_board{board.to_frame()} == board, true);
+    GTEST_ASSERT_EQ(compressed_board{bitboard_frame{}} == board, false);
+}
+
+TEST(training, record_encoding)
+{
+    training_record record;
+    record.board = compressed_board{bitboard_frame{}};
+    record.player_to_move = false;
+    record.score = -1234;
+    record.result = GAME_BLACK_WIN;
+    unsigned char bytes[TRAINING_RECORD_SIZE];
+    encode_training_record(record, bytes);
+    GTEST_ASSERT_EQ(bytes[33] | bytes[34]<<8, (uint16_t)-1234);
+
+    auto decoded {decode_training_record(bytes)};
+    GTEST_ASSERT_EQ(decoded.board == record.board, true);
+    GTEST_ASSERT_EQ(decoded.player_to_move, false);
+    GTEST_ASSERT_EQ(decoded.score, -1234);
+    GTEST_ASSERT_EQ(decoded.result, GAME_BLACK_WIN);
+    GTEST_ASSERT_EQ(decoded.hash(), zobrist_hash(bitboard_frame{}, false));
+}
+
+TEST(training, quiet_filter)
+{
+    const std::pair<const char*, bool> positions[] {
+        {START_FEN, true},
+        {"4k3/8/8/3r4/8/8/8/3RK3 w - - 0 1", false},       // rook takes rook
+        {"4k3/8/8/3q4/8/2N5/8/4K3 w - - 0 1", false},      // knight takes queen
+        {"4k3/8/8/3r4/8/1B6/8/4K3 w - - 0 1", false},      // bishop takes rook
+        {"4k3/8/8/8/8/8/3n4/3QK3 w - - 0 1", false},       // queen or king takes knight
+        {"4k3/8/8/8/8/8/4p3/4K3 w - - 0 1", false},        // king takes pawn
+        {"4k3/8/8/3pP3/8/8/8/4K3 w - d6 0 1", false},      // en passant
+        {"4k3/8/8/3pP3/8/8/8/4K3 w - - 0 1", true},
+        {"4k3/4r3/8/8/8/2p5/4N3/4K3 w - - 0 1", true},     // the knight is pinned
+        {"4k3/8/8/8/8/8/r7/4K2R w - - 0 1", true},         // nothing to take, no check
+        {"4k3/8/8/8/8/8/8/r3K2R w - - 0 1", false},        // checked by a rook that cannot be taken
+        {"4k3/8/8/8/8/8/8/4RK2 w - - 0 1", false},         // the side not to move is in check
+        {"4k3/8/8/8/8/8/3P4/2K5 b - - 0 1", true},
+        {"4k3/8/8/8/8/8/3P4/2K5 w - - 0 1", true},
+        {"4k3/3P4/8/8/8/8/8/2K5 w - - 0 1", false},        // the pawn gives check from d7
+    };
+    for(auto& [fen, quiet] : positions){
+        bitboard_frame frame;
+        position_state state;
+        GTEST_ASSERT_EQ(parse_fen(fen, frame, state), true);
+        GTEST_ASSERT_EQ(is_quiet_position(frame, state), quiet) << fen;
+    }
+}
+
+TEST(training, generate_and_resume)
+{
+    auto path {testing::TempDir() + "test_training.bin"};
+    std::remove(path.c_str());
+    training_options options;
+    options.threads = 3;
+    options.positions = 60;
+    options.nodes = 200;
+    options.rules.max_plies = 40;
+
+    training_stats stats;
+    GTEST_ASSERT_EQ(generate_training_data(path.c_str(), options, stats), true);
+    GTEST_ASSERT_EQ(stats.resumed, 0);
+    GTEST_ASSERT_EQ(stats.written, 60);
+    GTEST_ASSERT_GT(stats.games, 0);
+    GTEST_ASSERT_EQ(std::filesystem::file_size(path), 60*TRAINING_RECORD_SIZE);
+
+    // workers take game numbers in turn; once the file is full each may
+    // drop one game it was still playing
+    std::vector<training_record> candidates;
+    uint64_t plies{0};
+    for(uint64_t game_number=0, played=0; played < stats.games + options.threads; ++game_number){
+        game_record game;
+        if(!play_training_game(options, game_number, game)){
+            continue;
+        }
+        ++played;
+        GTEST_ASSERT_EQ(game.states.size(), game.positions.size());
+        plies += game.positions.size();
+        auto kept {expected_records(options, game)};
+        candidates.insert(candidates.end(), kept.begin(), kept.end());
+    }
+    auto records {read_records(path)};
+    for(auto& record : records){
+        auto found {std::find_if(candidates.begin(), candidates.end(), [&](auto& c){ return same_record(c, record); })};
+        GTEST_ASSERT_NE(found, candidates.end());
+    }
+    GTEST_ASSERT_LE(stats.written + stats.duplicates, candidates.size());
+    GTEST_ASSERT_LE(stats.written + stats.duplicates + stats.noisy, plies);
+
+    // an interrupted write leaves a torn record behind
+    {
+        std::ofstream torn(path, std::ios::binary | std::ios::app);
+        torn.write("partial", 7);
+    }
+    // a single worker plays the games in order, so the run can be replayed
+    options.threads = 1;
+    options.positions = 120;
+    GTEST_ASSERT_EQ(generate_training_data(path.c_str(), options, stats), true);
+    GTEST_ASSERT_EQ(stats.resumed, 60);
+    GTEST_ASSERT_EQ(stats.written, 60);
+
+    records = read_records(path);
+    GTEST_ASSERT_EQ(records.size(), 120);
+    std::set<uint64_t> hashes;
+    for(size_t i=0; i<stats.resumed; ++i){
+        hashes.insert(records[i].hash());
+    }
+    // the resumed run numbers its games after the records already there
+    size_t next {stats.resumed};
+    uint64_t games{0};
+    uint64_t considered{0};
+    uint64_t duplicates{0};
+    uint64_t noisy{0};
+    for(auto game_number {stats.resumed}; next < records.size() && games < stats.games; ++game_number){
+        game_record game;
+        if(!play_training_game(options, game_number, game)){
+            continue;
+        }
+        ++games;
+        auto kept {expected_records(options, game)};
+        noisy += game.positions.size() - kept.size();
+        for(auto& record : kept){
+            if(next == records.size()){
+                break;
+            }
+            ++considered;
+            if(!hashes.insert(record.hash()).second){
+                ++duplicates;
+                continue;
+            }
+            GTEST_ASSERT_EQ(same_record(records[next++], record), true) << "record " << next-1;
+        }
+    }
+    GTEST_ASSERT_EQ(next, records.size());
+    GTEST_ASSERT_EQ(games, stats.games);
+    GTEST_ASSERT_EQ(stats.duplicates, duplicates);
+    GTEST_ASSERT_EQ(stats.written + stats.duplicates, considered);
+    GTEST_ASSERT_EQ(stats.noisy, noisy);
+    GTEST_ASSERT_EQ(hashes.size(), records.size());
+
+    // without the offset the resumed run would replay the first run's games
+    game_record first, resumed;
+    GTEST_ASSERT_EQ(play_training_game(options, 0, first), true);
+    GTEST_ASSERT_EQ(play_training_game(options, stats.resumed, resumed), true);
+    GTEST_ASSERT_NE(first.start_fen, resumed.start_fen);
+    GTEST_ASSERT_LT(stats.duplicates, stats.written);
+
+    // already complete
+    GTEST_ASSERT_EQ(generate_training_data(path.c_str(), options, stats), true);
+    GTEST_ASSERT_EQ(stats.written, 0);
+    std::remove(path.c_str());
+}
@@ -0,0 +1,63 @@
+#include "analysis.h"
+#include "match.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+
+namespace{
+void usage(){
+    std::cerr<<"usage: analyze [options] [positions.epd]\n"
+        "  reads FEN/EPD lines from the file or stdin, writes one JSON line per position\n"
+        "  --threads N          worker threads (default: all cores)\n"
+        "  --depth N            search depth (default 6)\n"
+        "  --nodes N            node limit per position (default none)\n"
+        "  --hash MB            shared transposition table size (default 64)\n"
+        "  --queue N            positions read ahead of the workers (default 4 per thread)\n"
+        "  --engine SPEC        evaluation overrides, e.g. rook=520,advance=6"<<std::endl;
+}
+}
+
+int main(int argc, char** argv){
+    analysis_options options;
+    options.threads = std::thread::hardware_concurrency();
+    const char* input_path {nullptr};
+    engine_config engine;
+
+    for(int i=1; i<argc; ++i){
+        std::string arg {argv[i]};
+        if(arg.rfind("--", 0) != 0 && !input_path){
+            input_path = argv[i];
+            continue;
+        }
+        if(i+1 >= argc){
+            usage();
+            return 1;
+        }
+        std::string value {argv[++i]};
+        if(arg == "--threads") options.threads = (size_t)atoll(value.c_str());
+        else if(arg == "--depth") options.limits.depth = (size_t)atoll(value.c_str());
+        else if(arg == "--nodes") options.limits.nodes = (uint64_t)atoll(value.c_str());
+        else if(arg == "--hash") options.hash_mb = (size_t)atoll(value.c_str());
+        else if(arg == "--queue") options.queue_capacity = (size_t)atoll(value.c_str());
+        else if(arg == "--engine" && parse_engine_config(value, engine)) continue;
+        else{
+            usage();
+            return 1;
+        }
+    }
+    options.weights = engine.weights;
+
+    if(!input_path){
+        analyze_stream(std::cin, std::cout, options);
+        return 0;
+    }
+    std::ifstream input(input_path);
+    if(!input){
+        std::cerr<<"cannot read "<<input_path<<std::endl;
+        return 1;
+    }
+    analyze_stream(input, std::cout, options);
+}
@@ -0,0 +1,27 @@
+#include "book.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+
+int main(int argc, char** argv){
+    if(argc < 3){
+        std::cerr<<"usage: build_book <games.txt> <book.bin> [max_ply]\n";
+        std::cerr<<"games.txt holds one game per line in coordinate notation, e.g. e2e4 e7e5 g1f3"<<std::endl;
+        return 1;
+    }
+
+    std::ifstream games(argv[1]);
+    if(!games){
+        std::cerr<<"cannot read "<<argv[1]<<std::endl;
+        return 1;
+    }
+
+    book_builder builder(argc > 3? (size_t)atoll(argv[3]) : 20);
+    auto game_count {builder.add_games(games)};
+    if(!builder.write(argv[2])){
+        std::cerr<<"cannot write "<<argv[2]<<std::endl;
+        return 1;
+    }
+    std::cout<<game_count<<" games, "<<builder.counts.size()<<" entries written to "<<argv[2]<<std::endl;
+}
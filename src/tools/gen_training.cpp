@@ -0,0 +1,80 @@
+#include "match.h"
+#include "notation.h"
+#include "training.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+
+namespace{
+void usage(){
+    std::cerr<<"usage: gen_training [options] [output.bin]\n"
+        "  appends quiet self-play positions to the output (default training.bin);\n"
+        "  an existing file is resumed and its positions are never written twice\n"
+        "  --positions N        records the file should hold (default 1000000)\n"
+        "  --threads N          games played at once (default: all cores)\n"
+        "  --nodes N            node limit per move (default 5000)\n"
+        "  --random-plies N     random opening moves before recording (default 8)\n"
+        "  --max-score S        skip positions scored beyond S (default 3000)\n"
+        "  --hash MB            table size per engine and game (default 2)\n"
+        "  --seed N             opening seed (default 1)\n"
+        "  --start FEN          position the random openings start from\n"
+        "  --engine SPEC        evaluation overrides, e.g. rook=520,advance=6"<<std::endl;
+}
+}
+
+int main(int argc, char** argv){
+    training_options options;
+    options.threads = std::thread::hardware_concurrency();
+    const char* output_path {"training.bin"};
+    bool output_given {false};
+    engine_config engine;
+
+    for(int i=1; i<argc; ++i){
+        std::string arg {argv[i]};
+        if(arg.rfind("--", 0) != 0 && !output_given){
+            output_path = argv[i];
+            output_given = true;
+            continue;
+        }
+        if(i+1 >= argc){
+            usage();
+            return 1;
+        }
+        std::string value {argv[++i]};
+        if(arg == "--positions") options.positions = (size_t)atoll(value.c_str());
+        else if(arg == "--threads") options.threads = (size_t)atoll(value.c_str());
+        else if(arg == "--nodes") options.nodes = (uint64_t)atoll(value.c_str());
+        else if(arg == "--random-plies") options.random_plies = (size_t)atoll(value.c_str());
+        else if(arg == "--max-score") options.max_score = (int32_t)atoll(value.c_str());
+        else if(arg == "--hash") options.hash_mb = (size_t)atoll(value.c_str());
+        else if(arg == "--seed") options.seed = (uint64_t)atoll(value.c_str());
+        else if(arg == "--start" && parse_fen(value, options.start, options.start_state)) continue;
+        else if(arg == "--engine" && parse_engine_config(value, engine)) continue;
+        else{
+            usage();
+            return 1;
+        }
+    }
+    options.weights = engine.weights;
+
+    auto started {std::chrono::steady_clock::now()};
+    training_stats stats;
+    auto report = [&](const training_stats& progress){
+        if(progress.games % 100 != 0){
+            return;
+        }
+        auto seconds {std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count()};
+        std::cerr<<progress.games<<" games, "<<progress.resumed + progress.written<<" positions, "
+            <<(uint64_t)(progress.written/seconds)<<" positions/s"<<std::endl;
+    };
+    if(!generate_training_data(output_path, options, stats, report)){
+        std::cerr<<"cannot write "<<output_path<<std::endl;
+        return 1;
+    }
+    auto seconds {std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count()};
+    std::cout<<stats.resumed<<" positions resumed, "<<stats.written<<" written from "<<stats.games<<" games in "<<seconds<<" s\n"
+        <<stats.duplicates<<" duplicates and "<<stats.noisy<<" noisy positions skipped"<<std::endl;
+}
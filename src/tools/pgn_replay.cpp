@@ -0,0 +1,77 @@
+#include "notation.h"
+#include "pgn.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace{
+void usage(){
+    std::cerr<<"usage: pgn_replay <archive.pgn> [options]\n"
+        "  --threads N          replay threads (default: all cores)\n"
+        "  --fens FILE          write the FEN before every move\n"
+        "  --failures           list games that stopped on an unresolved move"<<std::endl;
+}
+}
+
+int main(int argc, char** argv){
+    if(argc < 2){
+        usage();
+        return 1;
+    }
+    size_t threads {std::thread::hardware_concurrency()};
+    const char* fens_path {nullptr};
+    bool show_failures{false};
+    for(int i=2; i<argc; ++i){
+        std::string arg {argv[i]};
+        if(arg == "--failures") show_failures = true;
+        else if(arg == "--threads" && i+1 < argc) threads = (size_t)atoll(argv[++i]);
+        else if(arg == "--fens" && i+1 < argc) fens_path = argv[++i];
+        else{
+            usage();
+            return 1;
+        }
+    }
+
+    pgn_archive archive;
+    if(!archive.open(argv[1])){
+        std::cerr<<"cannot read "<<argv[1]<<std::endl;
+        return 1;
+    }
+    std::ofstream fens;
+    if(fens_path){
+        fens.open(fens_path);
+        if(!fens){
+            std::cerr<<"cannot write "<<fens_path<<std::endl;
+            return 1;
+        }
+    }
+
+    std::mutex output_lock;
+    pgn_callbacks callbacks;
+    if(fens_path){
+        callbacks.on_move = [&](size_t, const pgn_game_info&, const pgn_ply& ply){
+            auto fen {to_fen(ply.frame, ply.state)};
+            std::lock_guard<std::mutex> guard{output_lock};
+            fens<<fen<<"\n";
+        };
+    }
+    if(show_failures){
+        callbacks.on_game = [&](size_t, const pgn_game_info& game){
+            if(!game.complete){
+                std::lock_guard<std::mutex> guard{output_lock};
+                std::cerr<<"game "<<game.number<<": stopped after "<<game.plies<<" plies at '"<<game.failed_token<<"'\n";
+            }
+        };
+    }
+
+    auto started {std::chrono::steady_clock::now()};
+    auto stats {replay_pgn(archive.data, archive.size, threads, callbacks)};
+    auto seconds {std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count()};
+    std::cout<<stats.games<<" games, "<<stats.plies<<" plies, "<<stats.failed_games<<" incomplete\n";
+    std::cout<<seconds<<" s, "<<(seconds > 0? stats.games/seconds : 0)<<" games/s on "<<threads<<" threads"<<std::endl;
+}
@@ -0,0 +1,178 @@
+#include "engine_stats.h"
+#include "match.h"
+#include "notation.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace{
+struct opening{
+    bitboard_frame frame;
+    position_state state;
+};
+
+void usage(){
+    std::cerr<<"usage: selfplay [options]\n"
+        "  --games N            games to play at most (default 1000)\n"
+        "  --concurrency N      games played at once (default: all cores)\n"
+        "  --openings FILE      EPD/FEN list, each opening is played with both colors\n"
+        "  --pgn FILE           PGN output (default selfplay.pgn)\n"
+        "  --a SPEC, --b SPEC   engine settings, e.g. name=new,depth=4,rook=520\n"
+        "  --elo0 E --elo1 E    SPRT hypotheses (default 0 and 5)\n"
+        "  --alpha P --beta P   SPRT error rates (default 0.05)\n"
+        "  --max-plies N --resign-score S --resign-plies N\n"
+        "  --draw-score S --draw-plies N --draw-after N   adjudication"<<std::endl;
+}
+
+bool load_openings(const char* path, std::vector<opening>& openings){
+    std::ifstream in(path);
+    if(!in){
+        return false;
+    }
+    std::string line;
+    while(std::getline(in, line)){
+        bitboard_frame frame;
+        position_state state;
+        if(parse_fen(line, frame, state)){
+            openings.push_back({frame, state});
+        }
+    }
+    return true;
+}
+}
+
+int main(int argc, char** argv){
+    size_t max_games{1000};
+    size_t concurrency {std::thread::hardware_concurrency()};
+    const char* openings_path {nullptr};
+    std::string pgn_path {"selfplay.pgn"};
+    engine_config engine_a;
+    engine_config engine_b;
+    engine_a.name = "A";
+    engine_b.name = "B";
+    engine_a.limits.depth = engine_b.limits.depth = 3;
+    adjudication_rules rules;
+    sprt_test sprt;
+
+    for(int i=1; i<argc; ++i){
+        std::string arg {argv[i]};
+        if(i+1 >= argc){
+            usage();
+            return 1;
+        }
+        std::string value {argv[++i]};
+        if(arg == "--games") max_games = (size_t)atoll(value.c_str());
+        else if(arg == "--concurrency") concurrency = (size_t)atoll(value.c_str());
+        else if(arg == "--openings") openings_path = argv[i];
+        else if(arg == "--pgn") pgn_path = value;
+        else if(arg == "--a" && parse_engine_config(value, engine_a)) continue;
+        else if(arg == "--b" && parse_engine_config(value, engine_b)) continue;
+        else if(arg == "--elo0") sprt.elo0 = atof(value.c_str());
+        else if(arg == "--elo1") sprt.elo1 = atof(value.c_str());
+        else if(arg == "--alpha") sprt.alpha = atof(value.c_str());
+        else if(arg == "--beta") sprt.beta = atof(value.c_str());
+        else if(arg == "--max-plies") rules.max_plies = (size_t)atoll(value.c_str());
+        else if(arg == "--resign-score") rules.resign_score = (int32_t)atoll(value.c_str());
+        else if(arg == "--resign-plies") rules.resign_plies = (size_t)atoll(value.c_str());
+        else if(arg == "--draw-score") rules.draw_score = (int32_t)atoll(value.c_str());
+        else if(arg == "--draw-plies") rules.draw_plies = (size_t)atoll(value.c_str());
+        else if(arg == "--draw-after") rules.draw_after_ply = (size_t)atoll(value.c_str());
+        else{
+            usage();
+            return 1;
+        }
+    }
+    if(concurrency == 0){
+        concurrency = 1;
+    }
+
+    std::vector<opening> openings;
+    if(openings_path && !load_openings(openings_path, openings)){
+        std::cerr<<"cannot read "<<openings_path<<std::endl;
+        return 1;
+    }
+    if(openings.empty()){
+        openings.push_back({bitboard_frame{}, true});
+    }
+
+    std::ofstream pgn(pgn_path);
+    if(!pgn){
+        std::cerr<<"cannot write "<<pgn_path<<std::endl;
+        return 1;
+    }
+
+    std::atomic<size_t> next_game{0};
+    std::atomic<bool> stop{false};
+    std::mutex results_lock;
+    uint64_t total_nodes{0};
+    size_t late_games{0};
+    auto started {std::chrono::steady_clock::now()};
+
+    auto worker = [&](){
+        for(;;){
+            auto game_index {next_game++};
+            if(game_index >= max_games || stop){
+                return;
+            }
+            // each opening twice, engine A taking white in the first game of the pair
+            auto& start {openings[(game_index/2) % openings.size()]};
+            auto a_white {game_index%2 == 0};
+            auto game {play_game(start.frame, start.state, a_white? engine_a : engine_b, a_white? engine_b : engine_a, rules)};
+
+            std::lock_guard<std::mutex> guard{results_lock};
+            total_nodes += game.nodes;
+            pgn<<to_pgn(game, "selfplay", game_index+1);
+            // games still running when the test stopped must not move the decision
+            if(stop){
+                ++late_games;
+                std::cout<<"game "<<game_index+1<<": "<<result_text(game.result)<<" after the decision, not counted"<<std::endl;
+                continue;
+            }
+            sprt.add(a_white? game.result : -game.result);
+            std::cout<<"game "<<game_index+1<<": "<<game.white<<" vs "<<game.black<<" "<<result_text(game.result)
+                <<" ("<<game.termination<<")  W/D/L "<<sprt.wins<<"/"<<sprt.draws<<"/"<<sprt.losses
+                <<"  LLR "<<std::fixed<<std::setprecision(2)<<sprt.llr()<<std::endl;
+            if(sprt.decision() != 0){
+                stop = true;
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for(size_t t=0; t<concurrency; ++t){
+        threads.emplace_back(worker);
+    }
+    for(auto& thread : threads){
+        thread.join();
+    }
+
+    auto seconds {std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count()};
+    std::cout<<"\n"<<engine_a.name<<" vs "<<engine_b.name<<": "<<sprt.games()<<" games, W/D/L "
+        <<sprt.wins<<"/"<<sprt.draws<<"/"<<sprt.losses<<", score "<<std::setprecision(1)<<100*sprt.score()<<"%\n";
+    std::cout<<"elo "<<sprt.elo()<<" +/- "<<sprt.elo_margin()<<"\n";
+    std::cout<<"SPRT elo0="<<sprt.elo0<<" elo1="<<sprt.elo1<<": LLR "<<std::setprecision(2)<<sprt.llr()
+        <<" ["<<sprt.lower_bound()<<", "<<sprt.upper_bound()<<"] ";
+    auto decision {sprt.decision()};
+    std::cout<<(decision > 0? "H1 accepted" : decision < 0? "H0 accepted" : "inconclusive")<<"\n";
+    if(late_games){
+        std::cout<<late_games<<" games finished after the decision are in the PGN but not counted\n";
+    }
+    std::cout<<std::setprecision(1)<<seconds<<" s, "<<total_nodes<<" nodes, "
+        <<std::setprecision(0)<<(seconds > 0? total_nodes/seconds : 0)<<" nps\n";
+    if(engine_stats_enabled()){
+        auto stats {aggregate_engine_stats()};
+        std::cout<<"tt hit rate "<<std::setprecision(3)<<stats.tt_hit_rate()
+            <<", first-move cutoffs "<<stats.first_move_cutoff_rate()
+            <<", branching factor "<<stats.branching_factor()<<"\n";
+    }
+    std::cout<<"PGN written to "<<pgn_path<<std::endl;
+}